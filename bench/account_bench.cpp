@@ -0,0 +1,60 @@
+#include "trade_sim/core/AccountManager.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace trade_sim;
+
+/**
+ * account_bench：账户内存占用（RSS 增量 / 账户数）与查找耗时
+ * 用法：account_bench [accounts=1000000] [positionsPerAccount=1]
+ */
+namespace {
+
+std::size_t residentBytes() {
+    std::ifstream in("/proc/self/statm");
+    std::size_t pages = 0, resident = 0;
+    in >> pages >> resident;
+    return resident * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t accounts = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const std::size_t perAccount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1;
+
+    std::vector<Symbol> syms;
+    for (std::size_t s = 0; s < 64; ++s) syms.push_back("SYM" + std::to_string(s));
+
+    const auto before = residentBytes();
+    AccountManager am;
+    using ms = std::chrono::duration<double, std::milli>;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t a = 0; a < accounts; ++a) {
+        const AccountId id = "acct" + std::to_string(a);
+        am.createAccount(id, Money(1'000'00));
+        auto& acct = am.getAccount(id);
+        for (std::size_t k = 0; k < perAccount; ++k) acct.addPosition(syms[(a + k) % syms.size()], 100);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const auto after = residentBytes();
+
+    std::int64_t total = 0;
+    for (std::size_t a = 0; a < accounts; a += 7) {
+        total += am.getAccount("acct" + std::to_string(a)).positionOf(syms[a % syms.size()]);
+    }
+    const auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << "accounts=" << accounts << " positions_per_account=" << perAccount
+              << " bytes_per_account=" << static_cast<double>(after - before) / static_cast<double>(accounts)
+              << " build_ms=" << ms(t1 - t0).count()
+              << " lookup_ns=" << ms(t2 - t1).count() * 1e6 / static_cast<double>((accounts + 6) / 7)
+              << " check=" << total << "\n";
+    return 0;
+}
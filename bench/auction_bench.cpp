@@ -0,0 +1,44 @@
+#include "trade_sim/core/MatchingEngine.h"
+#include "trade_sim/order/Orders.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace trade_sim;
+
+/**
+ * auction_bench：集合竞价出清耗时
+ * 用法：auction_bench [orders=1000000] [levels=2000]
+ */
+int main(int argc, char** argv) {
+    const std::size_t orders = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const long long levels = argc > 2 ? std::atoll(argv[2]) : 2'000;
+
+    MatchingEngine me(MatchingMode::Auction);
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<long long> price(10'000 - levels / 2, 10'000 + levels / 2);
+    std::uniform_int_distribution<std::int64_t> qty(1, 500);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < orders; ++i) {
+        const Side side = (i & 1) ? Side::Sell : Side::Buy;
+        LimitOrder o(static_cast<OrderId>(i + 1), "u", "AAPL", side, qty(rng), Money(price(rng)));
+        (void)me.match(o);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const auto trades = me.uncross("AAPL");
+    const auto t2 = std::chrono::steady_clock::now();
+
+    using ms = std::chrono::duration<double, std::milli>;
+    std::int64_t volume = 0;
+    for (const auto& t : trades) volume += t.qty;
+    std::cout << "orders=" << orders << " levels=" << levels
+              << " accumulate_ms=" << ms(t1 - t0).count()
+              << " uncross_ms=" << ms(t2 - t1).count()
+              << " trades=" << trades.size() << " volume=" << volume
+              << " price=" << (trades.empty() ? Money(0) : trades.front().price)
+              << " resting=" << me.pendingCount("AAPL") << "\n";
+    return 0;
+}
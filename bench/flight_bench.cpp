@@ -0,0 +1,67 @@
+#include "trade_sim/core/AccountManager.h"
+#include "trade_sim/core/FlightRecorder.h"
+#include "trade_sim/core/HistoryManager.h"
+#include "trade_sim/core/MatchingEngine.h"
+#include "trade_sim/core/OrderManager.h"
+#include "trade_sim/core/TradeExecutor.h"
+#include "trade_sim/order/OrderFactory.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace trade_sim;
+
+/**
+ * flight_bench：飞行记录单条开销，以及 submitAndProcess 开 / 关记录器的吞吐对比
+ * 用法：flight_bench [events=50000000] [orders=1000000]
+ */
+namespace {
+
+using ms = std::chrono::duration<double, std::milli>;
+
+/** 集合竞价：买卖交替同价，每 1000 笔出清一次，每两笔订单一笔成交 */
+double runOrders(std::size_t orders, bool recorderOn) {
+    FlightRecorder::setEnabled(recorderOn);
+    AccountManager am;
+    OrderManager om;
+    MatchingEngine me(MatchingMode::Auction);
+    HistoryManager hm;
+    TradeExecutor exec(am, om, me, hm);
+    am.createAccount("buyer", Money(static_cast<long long>(orders) * 100'00));
+    am.createAccount("seller", Money(0));
+    am.getAccount("seller").addPosition("BENCH", static_cast<std::int64_t>(orders));
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < orders; ++i) {
+        const bool buy = i % 2 == 0;
+        exec.submitAndProcess(OrderFactory::createLimitOrder(om.nextId(), buy ? "buyer" : "seller", "BENCH",
+                                                             buy ? Side::Buy : Side::Sell, 1, Money(100'00)));
+        if (i % 1000 == 999) exec.uncrossAllAndProcess();
+    }
+    const auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    FlightRecorder::setEnabled(true);
+    return static_cast<double>(orders) / secs;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t events = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50'000'000;
+    const std::size_t orders = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1'000'000;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < events; ++i) {
+        FlightRecorder::recordTrade(FlightEvent::Matched, i, i, i + 1, 1, Money(100));
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+
+    const double off = runOrders(orders, false);
+    const double on = runOrders(orders, true);
+
+    std::cout << "events=" << events << " ns_per_event=" << ms(t1 - t0).count() * 1e6 / static_cast<double>(events)
+              << " orders=" << orders << " orders_per_sec_off=" << off << " orders_per_sec_on=" << on
+              << " overhead_pct=" << (off / on - 1.0) * 100.0 << "\n";
+    return 0;
+}
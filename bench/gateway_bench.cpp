@@ -0,0 +1,187 @@
+#include "trade_sim/io/BinaryProtocol.h"
+#include "trade_sim/net/OrderGateway.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace trade_sim;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * gateway_bench：独立客户端进程压测 trade_sim_gateway
+ * 用法：gateway_bench (--unix PATH | --tcp PORT) [--connections N] [--orders M]
+ * - 每个连接先入金开户，再逐笔发送限价买单（每连接 1 笔在途）
+ * - 往返时延：发送请求 -> 收到该请求的 Accepted/Rejected 回报
+ */
+namespace {
+
+struct Conn {
+    int fd{-1};
+    std::vector<char> in;
+    std::size_t inLen{0};
+    std::size_t sent{0};
+    Clock::time_point sentAt;
+};
+
+int connectTo(const std::string& unixPath, std::uint16_t port) {
+    int fd = -1;
+    if (!unixPath.empty()) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, unixPath.c_str(), sizeof(addr.sun_path) - 1);
+        fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) return -1;
+    } else {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) return -1;
+        const int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+bool sendFrame(int fd, const WireMessage& m) {
+    char frame[kRequestFrameBytes];
+    const FrameLength len = sizeof(WireMessage);
+    std::memcpy(frame, &len, sizeof(len));
+    encodeMessage(m, frame + sizeof(len));
+    return ::send(fd, frame, sizeof(frame), MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(frame));
+}
+
+WireMessage makeOrder(std::size_t conn, std::uint64_t seq) {
+    WireMessage m;
+    m.type = static_cast<std::uint8_t>(MsgType::NewOrder);
+    m.kind = 1;
+    m.clientSeq = seq;
+    m.qty = 1;
+    m.amount = 100;
+    setWireString(m.account, "lc" + std::to_string(conn));
+    setWireString(m.symbol, "SYM" + std::to_string(conn % 8));
+    return m;
+}
+
+double percentile(const std::vector<std::int64_t>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const auto idx = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1));
+    return static_cast<double>(sorted[idx]) / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string unixPath;
+    std::uint16_t port = 0;
+    std::size_t connections = 1000;
+    std::size_t orders = 100;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i];
+        if (arg == "--unix") unixPath = argv[i + 1];
+        else if (arg == "--tcp") port = static_cast<std::uint16_t>(std::atoi(argv[i + 1]));
+        else if (arg == "--connections") connections = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (arg == "--orders") orders = std::strtoull(argv[i + 1], nullptr, 10);
+    }
+    if (unixPath.empty() && port == 0) {
+        std::cerr << "usage: gateway_bench (--unix PATH | --tcp PORT) [--connections N] [--orders M]\n";
+        return 1;
+    }
+
+    rlimit lim{};
+    if (::getrlimit(RLIMIT_NOFILE, &lim) == 0) {
+        lim.rlim_cur = lim.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &lim);
+    }
+
+    const int ep = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<Conn> conns(connections);
+    for (std::size_t i = 0; i < connections; ++i) {
+        conns[i].fd = connectTo(unixPath, port);
+        if (conns[i].fd < 0) {
+            std::cerr << "connect failed at session " << i << ": " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        conns[i].in.resize(64 * 1024);
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        ::epoll_ctl(ep, EPOLL_CTL_ADD, conns[i].fd, &ev);
+
+        WireMessage dep;
+        dep.type = static_cast<std::uint8_t>(MsgType::Deposit);
+        dep.amount = 1'000'000'000;
+        setWireString(dep.account, "lc" + std::to_string(i));
+        sendFrame(conns[i].fd, dep);
+    }
+
+    // 每连接：入金回报到达后开始逐笔下单；clientSeq = 0 表示入金
+    std::vector<std::int64_t> rttNs;
+    rttNs.reserve(connections * orders);
+    std::size_t done = 0;
+    std::size_t rejected = 0;
+    const auto t0 = Clock::now();
+    std::vector<epoll_event> events(1024);
+    while (done < connections) {
+        const int n = ::epoll_wait(ep, events.data(), static_cast<int>(events.size()), 5000);
+        if (n <= 0) {
+            std::cerr << "timeout waiting for reports\n";
+            return 1;
+        }
+        for (int e = 0; e < n; ++e) {
+            const auto i = static_cast<std::size_t>(events[e].data.u64);
+            Conn& c = conns[i];
+            const auto r = ::read(c.fd, c.in.data() + c.inLen, c.in.size() - c.inLen);
+            if (r <= 0) {
+                std::cerr << "session " << i << " closed by gateway\n";
+                return 1;
+            }
+            c.inLen += static_cast<std::size_t>(r);
+
+            std::size_t off = 0;
+            for (; c.inLen - off >= kReportFrameBytes; off += kReportFrameBytes) {
+                const WireReport rep = decodeReport(c.in.data() + off + sizeof(FrameLength));
+                if (rep.type == static_cast<std::uint8_t>(ReportType::Trade)) continue;
+                if (rep.clientSeq != 0) {
+                    rttNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - c.sentAt).count());
+                    if (rep.type == static_cast<std::uint8_t>(ReportType::Rejected)) ++rejected;
+                }
+                if (c.sent == orders) {
+                    ++done;
+                    continue;
+                }
+                ++c.sent;
+                c.sentAt = Clock::now();
+                sendFrame(c.fd, makeOrder(i, c.sent));
+            }
+            std::memmove(c.in.data(), c.in.data() + off, c.inLen - off);
+            c.inLen -= off;
+        }
+    }
+    const std::chrono::duration<double> secs = Clock::now() - t0;
+
+    std::sort(rttNs.begin(), rttNs.end());
+    std::cout << "connections=" << connections << " orders=" << rttNs.size() << " rejected=" << rejected
+              << " seconds=" << secs.count() << " orders_per_sec=" << rttNs.size() / secs.count() << "\n"
+              << "rtt_us p50=" << percentile(rttNs, 0.50) << " p90=" << percentile(rttNs, 0.90)
+              << " p99=" << percentile(rttNs, 0.99) << " p99.9=" << percentile(rttNs, 0.999)
+              << " max=" << percentile(rttNs, 1.0) << "\n";
+
+    for (auto& c : conns) ::close(c.fd);
+    ::close(ep);
+    return 0;
+}
@@ -0,0 +1,490 @@
+#include "trade_sim/common/Exceptions.h"
+#include "trade_sim/core/AccountManager.h"
+#include "trade_sim/core/HistoryManager.h"
+#include "trade_sim/core/MatchingEngine.h"
+#include "trade_sim/core/OrderManager.h"
+#include "trade_sim/core/TradeExecutor.h"
+#include "trade_sim/order/OrderFactory.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace trade_sim;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * load_gen：多主体合成负载，端到端压测 OrderFactory -> TradeExecutor
+ * 用法：load_gen [--accounts N] [--symbols S] [--zipf A] [--makers M] [--momentum K] [--noise Q]
+ *                [--rate OPS] [--seconds T] [--report SEC] [--auction-ms MS] [--seed X]
+ * - 做市商：各自守一个 symbol，每次行动撤掉旧报价、围绕最新价重新双边报价
+ * - 动量交易者：最新价偏离慢速均线时顺势下市价单，无信号时贴近最新价小量试探
+ * - 噪声交易者：随机方向、随机价位的限价单
+ * - 动量 / 噪声账户挂单达到上限时，本次行动改为撤最旧的一笔（簿深度不随运行时间增长）
+ * - symbol 热度服从 Zipf(A)：做市商分配、买单选股、账户初始持仓都按该分布抽样
+ * - --rate：每秒主体行动次数（做市商一次行动含撤 2 + 报 2 笔操作），0 为不限速；
+ *   限速时每次行动第一笔操作的时延从计划时刻算起（不受协调遗漏影响），其后各笔从上一笔完成算起
+ * - --auction-ms > 0：集合竞价模式，按墙钟定时出清；0：连续模式（当前无成交）
+ * - 每 --report 秒输出区间吞吐、时延分位、RSS；结束时输出全程汇总
+ */
+namespace {
+
+struct Options {
+    std::size_t accounts{10000};
+    std::size_t symbols{500};
+    double zipf{1.1};
+    std::size_t makers{200};
+    std::size_t momentum{200};
+    std::size_t noise{2000};
+    double rate{0};
+    double seconds{10};
+    double report{1};
+    int auctionMs{10};
+    std::uint64_t seed{1};
+};
+
+constexpr long long kInitialCash = 1'000'000'000'000LL; // 分；足够大，结算不因资金失败
+constexpr std::int64_t kInitialPosition = 1'000'000'000;
+constexpr std::size_t kHeldSymbols = 8;   // 非做市账户初始持仓的 symbol 数
+constexpr std::size_t kOpenLimit = 8;      // 动量 / 噪声账户最多同时挂单数
+constexpr long long kStartPrice = 100'00;
+
+/**
+ * 对数分桶时延直方图：每个 2 的幂区间再分 16 份，相对误差 < 1/16；定长，长跑不增长
+ */
+class LatencyHistogram {
+public:
+    void add(std::uint64_t ns) noexcept {
+        ++buckets_[index(ns)];
+        ++count_;
+        max_ = std::max(max_, ns);
+    }
+
+    void merge(const LatencyHistogram& o) noexcept {
+        for (std::size_t i = 0; i < kBuckets; ++i) buckets_[i] += o.buckets_[i];
+        count_ += o.count_;
+        max_ = std::max(max_, o.max_);
+    }
+
+    void reset() noexcept { *this = LatencyHistogram(); }
+
+    std::uint64_t count() const noexcept { return count_; }
+    std::uint64_t max() const noexcept { return max_; }
+
+    /** 分位（纳秒，取桶上界） */
+    std::uint64_t percentile(double p) const noexcept {
+        if (count_ == 0) return 0;
+        const auto rank = static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(count_)));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += buckets_[i];
+            if (seen >= std::max<std::uint64_t>(rank, 1)) return std::min(upper(i), max_);
+        }
+        return max_;
+    }
+
+private:
+    static constexpr std::size_t kBuckets = 64 * 16;
+
+    static std::size_t index(std::uint64_t v) noexcept {
+        if (v < 16) return static_cast<std::size_t>(v);
+        int msb = 63;
+        while (!(v >> msb)) --msb;
+        const int shift = msb - 4;
+        return static_cast<std::size_t>(shift) * 16 + static_cast<std::size_t>(v >> shift);
+    }
+
+    static std::uint64_t upper(std::size_t i) noexcept {
+        if (i < 16) return i;
+        const auto shift = i / 16 - 1;
+        const auto top = i % 16 + 16;
+        return ((top + 1) << shift) - 1;
+    }
+
+    std::array<std::uint64_t, kBuckets> buckets_{};
+    std::uint64_t count_{0};
+    std::uint64_t max_{0};
+};
+
+/** 当前进程常驻内存（MiB）；取不到返回 0 */
+double rssMb() {
+    std::ifstream in("/proc/self/status");
+    std::string key;
+    while (in >> key) {
+        if (key == "VmRSS:") {
+            double kb = 0;
+            in >> kb;
+            return kb / 1024.0;
+        }
+        in.ignore(1 << 16, '\n');
+    }
+    return 0.0;
+}
+
+struct SymbolState {
+    std::string name;
+    long long last{kStartPrice}; // 最新成交价（分）
+    double ema{kStartPrice};     // 慢速均线
+};
+
+struct Maker {
+    std::string account;
+    std::size_t symbol{0};
+    OrderId bid{0};
+    OrderId ask{0};
+};
+
+struct Trader {
+    std::string account;
+    std::vector<std::size_t> held; // 有持仓的 symbol
+    std::deque<OrderId> open;      // 在途挂单（可能已成交，撤单时按拒绝计）
+};
+
+class LoadGen {
+public:
+    explicit LoadGen(const Options& opt)
+        : opt_(opt),
+          engine_(opt.auctionMs > 0 ? MatchingMode::Auction : MatchingMode::Continuous),
+          exec_(accounts_, orders_, engine_, history_),
+          rng_(opt.seed) {
+        std::vector<double> weights(opt.symbols);
+        for (std::size_t k = 0; k < opt.symbols; ++k) weights[k] = 1.0 / std::pow(static_cast<double>(k + 1), opt.zipf);
+        zipf_ = std::discrete_distribution<std::size_t>(weights.begin(), weights.end());
+
+        symbols_.resize(opt.symbols);
+        for (std::size_t k = 0; k < opt.symbols; ++k) {
+            symbols_[k].name = "S" + std::to_string(k);
+            symbolIndex_.emplace(symbols_[k].name, k);
+        }
+
+        // 做市商各占一个账户；其余主体共用剩下的账户池
+        const std::size_t traderAccounts = opt.accounts > opt.makers ? opt.accounts - opt.makers : 1;
+        for (std::size_t m = 0; m < opt.makers; ++m) {
+            Maker mk;
+            mk.account = "MM" + std::to_string(m);
+            mk.symbol = zipf_(rng_);
+            accounts_.createAccount(mk.account, Money(kInitialCash));
+            accounts_.getAccount(mk.account).addPosition(symbols_[mk.symbol].name, kInitialPosition);
+            makers_.push_back(std::move(mk));
+        }
+        for (std::size_t a = 0; a < traderAccounts; ++a) {
+            Trader t;
+            t.account = "A" + std::to_string(a);
+            accounts_.createAccount(t.account, Money(kInitialCash));
+            for (std::size_t h = 0; h < kHeldSymbols; ++h) {
+                const auto s = zipf_(rng_);
+                if (std::find(t.held.begin(), t.held.end(), s) != t.held.end()) continue;
+                accounts_.getAccount(t.account).addPosition(symbols_[s].name, kInitialPosition);
+                t.held.push_back(s);
+            }
+            pool_.push_back(std::move(t));
+        }
+        noise_.resize(opt.noise);
+        for (auto& n : noise_) n = pickAccount();
+        momentum_.resize(opt.momentum);
+        for (auto& k : momentum_) k = pickAccount();
+    }
+
+    void run();
+
+private:
+    std::size_t pickAccount() { return std::uniform_int_distribution<std::size_t>(0, pool_.size() - 1)(rng_); }
+
+    /** 提交一笔订单并计时；返回 OrderId，失败返回 0 */
+    OrderId submit(const std::string& account, std::size_t symbol, Side side, std::int64_t qty, long long limit) {
+        const auto id = orders_.nextId();
+        try {
+            auto order = limit > 0
+                ? OrderFactory::createLimitOrder(id, account, symbols_[symbol].name, side, qty, Money(limit))
+                : OrderFactory::createMarketOrder(id, account, symbols_[symbol].name, side, qty);
+            exec_.submitAndProcess(std::move(order));
+            ++interval_.orders;
+        } catch (const TradeSimException&) {
+            ++interval_.rejects;
+            recordLatency();
+            return 0;
+        }
+        recordLatency();
+        return id;
+    }
+
+    void cancel(OrderId id) {
+        try {
+            exec_.cancel(id);
+            ++interval_.cancels;
+        } catch (const TradeSimException&) {
+            ++interval_.rejects; // 已成交 / 已撤
+        }
+        recordLatency();
+    }
+
+    /** 本笔操作时延 = 现在 - opStart_；下一笔从现在算起 */
+    void recordLatency() {
+        const auto now = Clock::now();
+        latency_.add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - opStart_).count()));
+        opStart_ = now;
+    }
+
+    static std::uint64_t elapsedNs(Clock::time_point start) {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    long long jitter(long long around, int ticks) {
+        const auto d = std::uniform_int_distribution<int>(-ticks, ticks)(rng_);
+        return std::max(1LL, around + d);
+    }
+
+    /** 一个主体行动一次；start 为计划时刻（限速）或当前时刻 */
+    void act(Clock::time_point start);
+    void actMaker(Maker& mk);
+    void actMomentum(Trader& t);
+    void actNoise(Trader& t);
+    bool cancelOldestIfFull(Trader& t);
+
+    void uncross();
+    void printInterval(double t, double secs);
+
+    struct Counters {
+        std::uint64_t orders{0};
+        std::uint64_t cancels{0};
+        std::uint64_t rejects{0};
+        std::uint64_t trades{0};
+        std::uint64_t settlementRejects{0};
+        std::uint64_t ops() const noexcept { return orders + cancels + rejects; }
+        void add(const Counters& o) noexcept {
+            orders += o.orders;
+            cancels += o.cancels;
+            rejects += o.rejects;
+            trades += o.trades;
+            settlementRejects += o.settlementRejects;
+        }
+    };
+
+    Options opt_;
+    AccountManager accounts_;
+    OrderManager orders_;
+    MatchingEngine engine_;
+    HistoryManager history_;
+    TradeExecutor exec_;
+
+    std::mt19937_64 rng_;
+    std::discrete_distribution<std::size_t> zipf_;
+    std::vector<SymbolState> symbols_;
+    std::unordered_map<std::string, std::size_t> symbolIndex_;
+    std::vector<Maker> makers_;
+    std::vector<Trader> pool_;
+    std::vector<std::size_t> noise_;    // 噪声交易者 -> pool_ 下标
+    std::vector<std::size_t> momentum_; // 动量交易者 -> pool_ 下标
+
+    Counters interval_;
+    Counters total_;
+    LatencyHistogram latency_;
+    LatencyHistogram totalLatency_;
+    LatencyHistogram uncrossLatency_;
+    Clock::time_point opStart_;
+};
+
+void LoadGen::act(Clock::time_point start) {
+    opStart_ = start;
+    const auto agents = makers_.size() + momentum_.size() + noise_.size();
+    auto a = std::uniform_int_distribution<std::size_t>(0, agents - 1)(rng_);
+    if (a < makers_.size()) return actMaker(makers_[a]);
+    a -= makers_.size();
+    if (a < momentum_.size()) return actMomentum(pool_[momentum_[a]]);
+    a -= momentum_.size();
+    actNoise(pool_[noise_[a]]);
+}
+
+void LoadGen::actMaker(Maker& mk) {
+    if (mk.bid) cancel(mk.bid);
+    if (mk.ask) cancel(mk.ask);
+    const auto& s = symbols_[mk.symbol];
+    const auto mid = jitter(s.last, 2);
+    const auto half = std::uniform_int_distribution<long long>(1, 5)(rng_);
+    const auto qty = std::uniform_int_distribution<std::int64_t>(10, 100)(rng_);
+    mk.bid = submit(mk.account, mk.symbol, Side::Buy, qty, std::max(1LL, mid - half));
+    mk.ask = submit(mk.account, mk.symbol, Side::Sell, qty, mid + half);
+}
+
+bool LoadGen::cancelOldestIfFull(Trader& t) {
+    if (t.open.size() < kOpenLimit) return false;
+    cancel(t.open.front());
+    t.open.pop_front();
+    return true;
+}
+
+void LoadGen::actMomentum(Trader& t) {
+    if (cancelOldestIfFull(t)) return;
+    const auto sym = zipf_(rng_);
+    const auto& s = symbols_[sym];
+    const auto qty = std::uniform_int_distribution<std::int64_t>(1, 50)(rng_);
+    const auto trend = static_cast<double>(s.last) - s.ema;
+    OrderId id = 0;
+    if (trend > s.ema * 0.001) {
+        id = submit(t.account, sym, Side::Buy, qty, 0);
+    } else if (trend < -s.ema * 0.001 && std::find(t.held.begin(), t.held.end(), sym) != t.held.end()) {
+        id = submit(t.account, sym, Side::Sell, qty, 0);
+    } else {
+        // 无信号：保证每次行动都产生一笔操作
+        id = submit(t.account, sym, Side::Buy, 1, s.last);
+    }
+    if (id) t.open.push_back(id);
+}
+
+void LoadGen::actNoise(Trader& t) {
+    if (cancelOldestIfFull(t)) return;
+    const bool sell = !t.held.empty() && std::uniform_int_distribution<int>(0, 1)(rng_) == 1;
+    const auto sym = sell ? t.held[std::uniform_int_distribution<std::size_t>(0, t.held.size() - 1)(rng_)] : zipf_(rng_);
+    const auto qty = std::uniform_int_distribution<std::int64_t>(1, 20)(rng_);
+    const auto id = submit(t.account, sym, sell ? Side::Sell : Side::Buy, qty, jitter(symbols_[sym].last, 10));
+    if (id) t.open.push_back(id);
+}
+
+void LoadGen::uncross() {
+    const auto start = Clock::now();
+    std::vector<SettlementReject> rejected;
+    const auto trades = exec_.uncrossAllAndProcess(&rejected);
+    interval_.settlementRejects += rejected.size();
+    uncrossLatency_.add(elapsedNs(start));
+    interval_.trades += trades.size();
+    for (const auto& t : trades) {
+        auto it = symbolIndex_.find(t.symbol);
+        if (it == symbolIndex_.end()) continue;
+        auto& s = symbols_[it->second];
+        s.last = t.price.cents();
+        s.ema += (static_cast<double>(s.last) - s.ema) * 0.05;
+    }
+}
+
+void LoadGen::printInterval(double t, double secs) {
+    std::cout << "t=" << t << "s ops_per_sec=" << static_cast<double>(interval_.ops()) / secs
+              << " orders=" << interval_.orders << " cancels=" << interval_.cancels << " rejects=" << interval_.rejects
+              << " trades=" << interval_.trades << " lat_us p50=" << latency_.percentile(0.50) / 1000.0
+              << " p99=" << latency_.percentile(0.99) / 1000.0 << " p99.9=" << latency_.percentile(0.999) / 1000.0
+              << " max=" << latency_.max() / 1000.0 << " rss_mb=" << rssMb() << " resting=" << engine_.restingCount()
+              << " orders_total=" << orders_.size() << "\n";
+}
+
+void LoadGen::run() {
+    const double rssStart = rssMb();
+    const auto start = Clock::now();
+    const auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(opt_.seconds));
+    const auto reportEvery = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(opt_.report));
+    const auto auctionEvery = std::chrono::milliseconds(std::max(opt_.auctionMs, 1));
+    const auto period = opt_.rate > 0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / opt_.rate))
+        : Clock::duration::zero();
+
+    auto nextReport = start + reportEvery;
+    auto lastReport = start;
+    auto nextUncross = start + auctionEvery;
+    auto due = start;
+
+    std::cout << "accounts=" << accounts_.size() << " symbols=" << symbols_.size() << " zipf=" << opt_.zipf
+              << " makers=" << makers_.size() << " momentum=" << momentum_.size() << " noise=" << noise_.size()
+              << " rate=" << (opt_.rate > 0 ? std::to_string(static_cast<long long>(opt_.rate)) : "max")
+              << " auction_ms=" << opt_.auctionMs << " rss_mb=" << rssStart << "\n";
+
+    for (auto now = Clock::now(); now < end; now = Clock::now()) {
+        if (opt_.auctionMs > 0 && now >= nextUncross) {
+            uncross();
+            nextUncross += auctionEvery;
+            if (nextUncross < now) nextUncross = now + auctionEvery; // 出清跟不上时不补做
+        }
+        if (now >= nextReport) {
+            printInterval(std::chrono::duration<double>(now - start).count(),
+                          std::chrono::duration<double>(now - lastReport).count());
+            total_.add(interval_);
+            interval_ = Counters();
+            totalLatency_.merge(latency_);
+            latency_.reset();
+            lastReport = now;
+            nextReport += reportEvery;
+        }
+
+        if (period > Clock::duration::zero()) {
+            // 限速：按计划时刻发出；落后时立即追赶，时延仍从计划时刻算
+            if (now < due) {
+                // 远离计划时刻才睡，并提前醒来自旋，避免睡过头被计入时延
+                if (due - now > std::chrono::milliseconds(2)) std::this_thread::sleep_until(due - std::chrono::milliseconds(1));
+                continue;
+            }
+            act(due);
+            due += period;
+        } else {
+            act(now);
+        }
+    }
+
+    total_.add(interval_);
+    totalLatency_.merge(latency_);
+    const double secs = std::chrono::duration<double>(Clock::now() - start).count();
+    const double rssEnd = rssMb();
+    const double millionOrders = static_cast<double>(total_.orders) / 1e6;
+    std::cout << "summary seconds=" << secs << " ops=" << total_.ops()
+              << " ops_per_sec=" << static_cast<double>(total_.ops()) / secs << " orders=" << total_.orders
+              << " cancels=" << total_.cancels << " rejects=" << total_.rejects << " trades=" << total_.trades
+              << " settlement_rejects=" << total_.settlementRejects << "\n"
+              << "summary lat_us p50=" << totalLatency_.percentile(0.50) / 1000.0
+              << " p90=" << totalLatency_.percentile(0.90) / 1000.0 << " p99=" << totalLatency_.percentile(0.99) / 1000.0
+              << " p99.9=" << totalLatency_.percentile(0.999) / 1000.0
+              << " p99.99=" << totalLatency_.percentile(0.9999) / 1000.0 << " max=" << totalLatency_.max() / 1000.0 << "\n"
+              << "summary uncross_ms count=" << uncrossLatency_.count()
+              << " p50=" << uncrossLatency_.percentile(0.50) / 1e6 << " p99=" << uncrossLatency_.percentile(0.99) / 1e6
+              << " max=" << uncrossLatency_.max() / 1e6 << "\n"
+              << "summary rss_mb start=" << rssStart << " end=" << rssEnd << " growth=" << rssEnd - rssStart
+              << " growth_mb_per_million_orders=" << (millionOrders > 0 ? (rssEnd - rssStart) / millionOrders : 0.0)
+              << " resting=" << engine_.restingCount() << " orders_total=" << orders_.size()
+              << " history_trades=" << history_.tradeCount() << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string arg = argv[i];
+        const char* v = argv[i + 1];
+        if (arg == "--accounts") opt.accounts = std::strtoull(v, nullptr, 10);
+        else if (arg == "--symbols") opt.symbols = std::strtoull(v, nullptr, 10);
+        else if (arg == "--zipf") opt.zipf = std::atof(v);
+        else if (arg == "--makers") opt.makers = std::strtoull(v, nullptr, 10);
+        else if (arg == "--momentum") opt.momentum = std::strtoull(v, nullptr, 10);
+        else if (arg == "--noise") opt.noise = std::strtoull(v, nullptr, 10);
+        else if (arg == "--rate") opt.rate = std::atof(v);
+        else if (arg == "--seconds") opt.seconds = std::atof(v);
+        else if (arg == "--report") opt.report = std::atof(v);
+        else if (arg == "--auction-ms") opt.auctionMs = std::atoi(v);
+        else if (arg == "--seed") opt.seed = std::strtoull(v, nullptr, 10);
+        else {
+            std::cerr << "unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+    if (opt.symbols == 0 || opt.accounts < 2 || opt.makers + opt.momentum + opt.noise == 0 || opt.report <= 0) {
+        std::cerr << "usage: load_gen [--accounts N>=2] [--symbols S>=1] [--zipf A] [--makers M] [--momentum K] "
+                     "[--noise Q] [--rate OPS] [--seconds T] [--report SEC>0] [--auction-ms MS] [--seed X]\n";
+        return 1;
+    }
+
+    try {
+        LoadGen gen(opt);
+        gen.run();
+    } catch (const TradeSimException& e) {
+        std::cerr << "[TradeSimException] code=" << static_cast<int>(e.code()) << " msg=" << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "trade_sim/core/AccountManager.h"
+#include "trade_sim/core/HistoryManager.h"
+#include "trade_sim/core/MatchingEngine.h"
+#include "trade_sim/core/OrderEntryHandler.h"
+#include "trade_sim/core/OrderManager.h"
+#include "trade_sim/core/TradeExecutor.h"
+#include "trade_sim/io/BinaryProtocol.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace trade_sim;
+
+/**
+ * order_entry_bench：二进制订单流解码 + 处理吞吐
+ * 用法：order_entry_bench [messages=2000000] [out.bin]
+ * - 给出 out.bin 时只生成输入流文件（可直接喂给 trade_sim_cli）
+ */
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    const std::size_t accounts = 1'000;
+
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<std::int64_t> price(9'900, 10'100);
+    std::uniform_int_distribution<std::int64_t> qty(1, 100);
+
+    std::vector<char> stream((count + accounts) * sizeof(WireMessage));
+    char* p = stream.data();
+    std::uint64_t seq = 0;
+    for (std::size_t a = 0; a < accounts; ++a, p += sizeof(WireMessage)) {
+        WireMessage m;
+        m.type = static_cast<std::uint8_t>(MsgType::Deposit);
+        m.clientSeq = ++seq;
+        m.amount = 1'000'000'000;
+        setWireString(m.account, "acct" + std::to_string(a));
+        encodeMessage(m, p);
+    }
+    for (std::size_t i = 0; i < count; ++i, p += sizeof(WireMessage)) {
+        WireMessage m;
+        m.clientSeq = ++seq;
+        if (i % 4 == 3) {
+            m.type = static_cast<std::uint8_t>(MsgType::Cancel);
+            m.orderId = i - i / 4; // 撤掉前一笔（此前每 4 条有 1 条撤单不占订单号）
+            setWireString(m.account, "acct" + std::to_string((i - 1) % accounts));
+        } else {
+            m.type = static_cast<std::uint8_t>(MsgType::NewOrder);
+            m.side = 0; // 只有买单：输入流不依赖初始持仓
+            m.kind = 1;
+            m.qty = qty(rng);
+            m.amount = price(rng);
+            setWireString(m.account, "acct" + std::to_string(i % accounts));
+            setWireString(m.symbol, "SYM" + std::to_string(i % 16));
+        }
+        encodeMessage(m, p);
+    }
+
+    if (argc > 2) {
+        std::FILE* f = std::fopen(argv[2], "wb");
+        if (!f || std::fwrite(stream.data(), 1, stream.size(), f) != stream.size()) {
+            std::cerr << "cannot write " << argv[2] << "\n";
+            return 1;
+        }
+        std::fclose(f);
+        return 0;
+    }
+
+    AccountManager am;
+    OrderManager om;
+    MatchingEngine me(MatchingMode::Auction);
+    HistoryManager hm;
+    TradeExecutor exec(am, om, me, hm);
+    OrderEntryHandler handler(am, om, exec);
+    std::vector<WireReport> reports;
+    reports.reserve(1 << 14);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::size_t reportCount = 0;
+    for (const char* q = stream.data(); q != stream.data() + stream.size(); q += sizeof(WireMessage)) {
+        handler.handle(decodeMessage(q), reports);
+        if (reports.size() >= (1 << 14)) {
+            reportCount += reports.size();
+            reports.clear();
+        }
+    }
+    reportCount += reports.size();
+    const std::chrono::duration<double> secs = std::chrono::steady_clock::now() - t0;
+
+    const auto total = count + accounts;
+    std::cout << "messages=" << total << " reports=" << reportCount << " seconds=" << secs.count()
+              << " msg_per_sec=" << total / secs.count() << "\n";
+    return 0;
+}
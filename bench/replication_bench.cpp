@@ -0,0 +1,168 @@
+#include "trade_sim/core/AccountManager.h"
+#include "trade_sim/core/HistoryManager.h"
+#include "trade_sim/core/MatchingEngine.h"
+#include "trade_sim/core/OrderEntryHandler.h"
+#include "trade_sim/core/OrderManager.h"
+#include "trade_sim/core/TradeExecutor.h"
+#include "trade_sim/io/BinaryProtocol.h"
+#include "trade_sim/net/Replication.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace trade_sim;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * replication_bench：主备复制对主节点关键路径的开销
+ * 用法：replication_bench [inputs=1000000] [batch=64]
+ * - 主节点在本线程逐条 publish + handle，每 batch 条 flush 一次（相当于一轮事件循环）
+ * - 备节点在另一线程经 Unix socket 接收并应用
+ * - 对比：不复制 / 只 publish+flush（不处理）/ publish+flush+处理；最后等待备节点追平
+ * - 同时给出墙钟与主线程 CPU 时间：单核机器上备节点线程与主节点抢同一个核，
+ *   墙钟含备节点的应用时间，主线程 CPU 时间才是复制加在关键路径上的开销
+ */
+namespace {
+
+constexpr int kAccounts = 64;
+
+struct Node {
+    AccountManager am;
+    OrderManager om;
+    MatchingEngine me{MatchingMode::Auction};
+    HistoryManager hm;
+    TradeExecutor exec{am, om, me, hm};
+    OrderEntryHandler handler{am, om, exec};
+
+    Node() {
+        for (int a = 0; a < kAccounts; ++a) {
+            const auto id = "rb" + std::to_string(a);
+            am.createAccount(id, Money(1'000'000'000));
+            am.getAccount(id).addPosition("RB0", 1'000'000'000);
+            am.getAccount(id).addPosition("RB1", 1'000'000'000);
+        }
+    }
+};
+
+/** 输入流：每 1000 条出清一次，其余为买卖交替的限价单 */
+std::vector<WireMessage> makeInputs(std::size_t n) {
+    std::vector<WireMessage> v(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        WireMessage& m = v[i];
+        if (i % 1000 == 999) continue; // type = 0：出清
+        m.type = static_cast<std::uint8_t>(MsgType::NewOrder);
+        m.side = static_cast<std::uint8_t>(i % 2);
+        m.kind = 1;
+        m.clientSeq = i + 1;
+        m.qty = 1 + static_cast<std::int64_t>(i % 5);
+        m.amount = 100 + static_cast<std::int64_t>(i % 7) - 3;
+        setWireString(m.account, "rb" + std::to_string(i % kAccounts));
+        setWireString(m.symbol, i % 3 == 0 ? "RB0" : "RB1");
+    }
+    return v;
+}
+
+void apply(Node& n, const WireMessage& m, std::vector<WireReport>& out) {
+    if (m.type == 0) {
+        n.handler.uncrossAll(out);
+    } else {
+        n.handler.handle(m, out);
+    }
+    out.clear();
+}
+
+/** 本线程 CPU 时间（纳秒） */
+std::int64_t threadCpuNs() {
+    timespec ts{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+double nsPer(Clock::duration d, std::size_t n) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()) /
+           static_cast<double>(n);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t inputs = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const std::size_t batch = std::max<std::size_t>(1, argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64);
+    const auto msgs = makeInputs(inputs);
+    std::vector<WireReport> out;
+
+    // 1) 不复制
+    Node plain;
+    const auto cpu0 = threadCpuNs();
+    auto t0 = Clock::now();
+    for (const auto& m : msgs) apply(plain, m, out);
+    const auto plainTime = Clock::now() - t0;
+    const auto plainCpu = std::chrono::nanoseconds(threadCpuNs() - cpu0);
+
+    // 2) / 3) 复制：备节点在独立线程
+    struct Result {
+        Clock::duration wall{};
+        Clock::duration cpu{};
+        Clock::duration catchUp{};
+        std::uint64_t applied{0};
+    };
+    auto run = [&](bool process) {
+        Result res;
+        const std::string path = "/tmp/replication_bench_" + std::to_string(::getpid()) + ".sock";
+        Node standbyNode;
+        ReplicationConfig cfg;
+        cfg.unixPath = path;
+        ReplicationStandby standby(standbyNode.handler, cfg);
+        standby.listen();
+        std::thread loop([&] { standby.run(); });
+
+        Node primary;
+        ReplicationPublisher pub(cfg);
+        pub.connect();
+        const auto startCpu = threadCpuNs();
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < msgs.size(); ++i) {
+            const auto& m = msgs[i];
+            if (m.type == 0) {
+                pub.publishUncross();
+            } else {
+                pub.publish(m);
+            }
+            if (process) apply(primary, m, out);
+            if (i % batch == batch - 1) pub.flush();
+        }
+        pub.flush();
+        const auto end = Clock::now();
+        res.cpu = std::chrono::nanoseconds(threadCpuNs() - startCpu);
+        pub.waitAcked(pub.publishedSeq(), 600'000);
+        res.wall = end - start;
+        res.catchUp = Clock::now() - end;
+        res.applied = standby.appliedSeq();
+        pub.close();
+        loop.join();
+        return res;
+    };
+
+    const auto publishOnly = run(false);
+    const auto replicated = run(true);
+
+    std::cout << "inputs=" << inputs << " batch=" << batch << " hw_threads=" << std::thread::hardware_concurrency()
+              << "\n"
+              << "primary_wall_ns_per_input no_replication=" << nsPer(plainTime, inputs)
+              << " publish_flush_only=" << nsPer(publishOnly.wall, inputs)
+              << " with_replication=" << nsPer(replicated.wall, inputs) << "\n"
+              << "primary_cpu_ns_per_input no_replication=" << nsPer(plainCpu, inputs)
+              << " publish_flush_only=" << nsPer(publishOnly.cpu, inputs)
+              << " with_replication=" << nsPer(replicated.cpu, inputs)
+              << " overhead=" << nsPer(replicated.cpu, inputs) - nsPer(plainCpu, inputs) << "\n"
+              << "standby applied=" << replicated.applied << "/" << inputs << " catch_up_ms_after_last_flush="
+              << std::chrono::duration<double, std::milli>(replicated.catchUp).count() << "\n";
+    return publishOnly.applied == inputs && replicated.applied == inputs ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+#include "trade_sim/core/AccountManager.h"
+#include "trade_sim/core/HistoryManager.h"
+#include "trade_sim/core/MatchingEngine.h"
+#include "trade_sim/core/OrderManager.h"
+#include "trade_sim/io/Snapshot.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace trade_sim;
+
+/**
+ * snapshot_bench：从二进制快照冷启动的耗时
+ * 用法：snapshot_bench [accounts=10000000] [trades=100000000] [tradesPerRound=10000000] [dir=.]
+ * - 成交分轮写入：每轮在上一轮快照（映射）之上记录 tradesPerRound 笔再合并存盘，
+ *   内存里只需容纳一轮的成交
+ * - 最后在全新的管理器上计时 Snapshot::load，并抽样 historyOf
+ */
+namespace {
+
+using ms = std::chrono::duration<double, std::milli>;
+
+std::size_t residentBytes() {
+    std::ifstream in("/proc/self/statm");
+    std::size_t pages = 0, resident = 0;
+    in >> pages >> resident;
+    return resident * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+std::size_t fileBytes(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    return in ? static_cast<std::size_t>(in.tellg()) : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t accounts = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+    const std::size_t trades = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100'000'000;
+    const std::size_t perRound = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 10'000'000;
+    const std::string dir = argc > 4 ? argv[4] : ".";
+    const std::string path = dir + "/snapshot_bench.snap";
+
+    std::vector<Symbol> syms;
+    for (std::size_t s = 0; s < 64; ++s) syms.push_back("SYM" + std::to_string(s));
+
+    AccountManager am;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t a = 0; a < accounts; ++a) {
+        const AccountId id = "acct" + std::to_string(a);
+        am.createAccount(id, Money(1'000'00));
+        am.getAccount(id).addPosition(syms[a % syms.size()], 100);
+    }
+    const auto buildMs = ms(std::chrono::steady_clock::now() - t0).count();
+
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<std::size_t> pickAccount(0, accounts - 1);
+    OrderManager om;
+    MatchingEngine me(MatchingMode::Auction);
+    TradeId nextTrade = 1;
+    double recordMs = 0, saveMs = 0;
+    for (std::size_t done = 0; done < trades || done == 0;) {
+        HistoryManager hm;
+        if (done) hm.loadSnapshot(SnapshotView::open(path));
+        const auto n = std::min(perRound, trades - done);
+        const auto r0 = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            const Trade t{nextTrade++, nextTrade, nextTrade + 1, syms[i % syms.size()], 10, Money(100'00)};
+            hm.record(t, "acct" + std::to_string(pickAccount(rng)), "acct" + std::to_string(pickAccount(rng)));
+        }
+        const auto r1 = std::chrono::steady_clock::now();
+        me.restoreNextTradeId(nextTrade);
+        Snapshot::save(path + ".next", am, om, me, hm);
+        std::rename((path + ".next").c_str(), path.c_str());
+        const auto r2 = std::chrono::steady_clock::now();
+        recordMs += ms(r1 - r0).count();
+        saveMs += ms(r2 - r1).count();
+        done += n;
+        std::cerr << "round: trades=" << done << " record_ms=" << ms(r1 - r0).count()
+                  << " save_ms=" << ms(r2 - r1).count() << "\n";
+        if (n == 0) break;
+    }
+
+    // 冷启动：全新管理器
+    { AccountManager drop; std::swap(drop, am); }
+    const auto rssBefore = residentBytes();
+    AccountManager amR;
+    OrderManager omR;
+    MatchingEngine meR(MatchingMode::Auction);
+    HistoryManager hmR;
+    const auto l0 = std::chrono::steady_clock::now();
+    const auto view = SnapshotView::open(path);
+    const auto l1 = std::chrono::steady_clock::now();
+    const auto restored = Snapshot::load(path, amR, omR, meR, hmR);
+    const auto l2 = std::chrono::steady_clock::now();
+
+    std::cout << "accounts=" << amR.size() << " trades=" << hmR.tradeCount() << " file_mb=" << fileBytes(path) / 1e6
+              << " build_accounts_ms=" << buildMs << " record_trades_ms=" << recordMs << " save_ms=" << saveMs
+              << " open_ms=" << ms(l1 - l0).count() << " load_ms=" << ms(l2 - l1).count()
+              << " load_rss_mb=" << (residentBytes() - rssBefore) / 1e6 << " next_trade_id=" << meR.nextTradeId()
+              << std::endl;
+
+    // 抽样查询：映射页未驻留时每次查询有数次随机读盘
+    std::size_t sampled = 0;
+    const std::size_t queries = 10'000;
+    for (std::size_t i = 0; i < queries; ++i) sampled += hmR.historyOf("acct" + std::to_string(pickAccount(rng))).size();
+    const auto l3 = std::chrono::steady_clock::now();
+    std::cout << "history_queries=" << queries << " history_query_us=" << ms(l3 - l2).count() * 1e3 / static_cast<double>(queries)
+              << " sampled=" << sampled << "\n";
+    std::remove(path.c_str());
+    return 0;
+}
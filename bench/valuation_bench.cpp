@@ -0,0 +1,62 @@
+#include "trade_sim/core/ValuationEngine.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace trade_sim;
+
+/**
+ * valuation_bench：增量盯市 / 日终全量重估耗时
+ * 用法：valuation_bench [positions=10000000] [symbols=5000]
+ * - 账户数 = positions / 10，每账户 10 个持仓
+ */
+int main(int argc, char** argv) {
+    const std::size_t positions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+    const std::size_t symbols = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5'000;
+    const std::size_t accounts = positions / 10;
+
+    std::vector<Symbol> syms;
+    for (std::size_t s = 0; s < symbols; ++s) syms.push_back("S" + std::to_string(s));
+
+    std::mt19937_64 rng(1);
+    std::uniform_int_distribution<std::size_t> pickSym(0, symbols - 1);
+    std::uniform_int_distribution<long long> px(1'000, 50'000);
+
+    ValuationEngine ve;
+    for (const auto& s : syms) ve.onPrice(s, Money(px(rng)));
+
+    using ms = std::chrono::duration<double, std::milli>;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t a = 0; a < accounts; ++a) {
+        const AccountId id = "acct" + std::to_string(a);
+        for (std::size_t k = 0; k < 10; ++k) {
+            ve.applyFill(id, syms[(a * 10 + k) % symbols], 100, Money(px(rng)));
+        }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+
+    const std::size_t ticks = 100'000;
+    for (std::size_t i = 0; i < ticks; ++i) ve.onPrice(syms[pickSym(rng)], Money(px(rng)));
+    const auto t2 = std::chrono::steady_clock::now();
+
+    const Trade t{1, 1, 2, syms[0], 10, Money(20'000)};
+    const std::size_t trades = 1'000'000;
+    for (std::size_t i = 0; i < trades; ++i) {
+        ve.onTrade(t, "acct" + std::to_string(i % accounts), "acct" + std::to_string((i + 1) % accounts));
+    }
+    const auto t3 = std::chrono::steady_clock::now();
+
+    ve.revalueAll();
+    const auto t4 = std::chrono::steady_clock::now();
+
+    std::cout << "positions=" << ve.positionCount() << " accounts=" << accounts << " symbols=" << symbols << "\n"
+              << "build_ms=" << ms(t1 - t0).count() << "\n"
+              << "tick_ns=" << ms(t2 - t1).count() * 1e6 / ticks << " (holders/symbol=" << positions / symbols << ")\n"
+              << "trade_ns=" << ms(t3 - t2).count() * 1e6 / trades << " (incl. account id formatting)\n"
+              << "revalue_all_ms=" << ms(t4 - t3).count() << "\n";
+    return 0;
+}
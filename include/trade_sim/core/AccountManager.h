@@ -2,13 +2,21 @@
 
 #include "trade_sim/model/Account.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 namespace trade_sim {
 
+class SnapshotView;
+class SnapshotWriter;
+
 /**
  * AccountManager：账户仓库（内存版 + 文件持久化接口）
+ * - accounts_：稠密账户表，deque 保证 getAccount 返回的引用长期有效
+ * - slots_：开放寻址索引（线性探测），每槽 8 字节：id 哈希低 32 位 + 下标
  */
 class AccountManager {
 public:
@@ -17,13 +25,39 @@ public:
     const Account& getAccount(const AccountId& id) const;
 
     bool exists(const AccountId& id) const noexcept;
+    std::size_t size() const noexcept { return accounts_.size(); }
+
+    /** 按创建顺序遍历账户 */
+    template <class F>
+    void forEachAccount(F&& f) const {
+        for (const auto& a : accounts_) f(a);
+    }
 
     // 文件读写（训练点）
     void loadFromFile(const std::string& path);
     void saveToFile(const std::string& path) const;
 
+    /**
+     * 二进制快照：Accounts / Positions / AccountSlots 三段
+     * - load 要求当前为空；哈希探针一致时索引整段拷贝，否则按记录重建
+     * - 强保证：失败时不修改
+     */
+    void saveSnapshot(SnapshotWriter& w) const;
+    void loadSnapshot(const SnapshotView& view);
+
 private:
-    std::unordered_map<AccountId, Account> accounts_;
+    struct Slot {
+        std::uint32_t hash{0};
+        std::uint32_t index{kEmpty};
+    };
+    static constexpr std::uint32_t kEmpty = ~std::uint32_t{0};
+
+    const Account* find(const AccountId& id) const noexcept;
+    void insertSlot(std::uint32_t hash, std::uint32_t index) noexcept;
+    void grow();
+
+    std::deque<Account> accounts_;
+    std::vector<Slot> slots_; // 容量为 2 的幂
 };
 
 } // namespace trade_sim
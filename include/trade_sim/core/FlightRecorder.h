@@ -0,0 +1,217 @@
+#pragma once
+
+#include "trade_sim/common/Exceptions.h"
+#include "trade_sim/common/Types.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace trade_sim {
+
+/** 飞行记录事件类型 */
+enum class FlightEvent : std::uint8_t {
+    Accepted = 1,        // 订单入库：orderId, side, qty, price = 限价
+    Matched = 2,         // 撮合产生成交：tradeId, orderId = 买单, contraId = 卖单, qty, price
+    Settled = 3,         // 成交完成账户结算（字段同 Matched）
+    Rejected = 4,        // 处理失败：orderId, error = ErrorCode；结算失败时另带 tradeId, contraId
+    HistoryRecorded = 5, // 成交写入历史（字段同 Matched）
+    Cancelled = 6,       // 撤单：orderId
+    Amended = 7          // 改单：orderId, qty = 新总量, price = 新限价
+};
+
+/** 一条记录占一个 cache line；seq 为所在线程环的写入序号 */
+struct FlightRecord {
+    std::uint64_t ticks{0};    // 时间戳计数（x86 为 TSC，其它平台为 steady_clock 纳秒）
+    std::uint64_t seq{0};
+    std::uint8_t type{0};      // FlightEvent
+    std::uint8_t error{0};     // Rejected：ErrorCode
+    std::uint8_t side{0};      // 0 = Buy, 1 = Sell
+    std::uint8_t reserved{0};
+    std::uint32_t thread{0};   // 环编号
+    std::uint64_t orderId{0};
+    std::uint64_t contraId{0};
+    std::uint64_t tradeId{0};
+    std::int64_t qty{0};
+    std::int64_t price{0};     // 分
+};
+
+static_assert(sizeof(FlightRecord) == 64, "FlightRecord must be 64 bytes");
+static_assert(sizeof(FlightRecord) % sizeof(std::uint64_t) == 0, "FlightRecord must pack into 64-bit words");
+static_assert(std::is_trivially_copyable<FlightRecord>::value, "FlightRecord must be trivially copyable");
+
+/**
+ * 转储文件格式（本机字节序）：
+ * FlightDumpHeader，随后 ringCount 个 [FlightRingHeader + count 条 FlightRecord]，
+ * 每个环内按 seq 递增排列
+ */
+struct FlightDumpHeader {
+    char magic[8]{};                // "TSFLIGHT"
+    std::uint32_t version{0};
+    std::uint32_t recordSize{0};
+    std::uint32_t ringCount{0};
+    std::uint32_t reserved{0};
+    // 时钟标定：记录器启动时与转储时各取一对 (ticks, steady_clock 纳秒)
+    std::uint64_t startTicks{0};
+    std::uint64_t startNanos{0};
+    std::uint64_t dumpTicks{0};
+    std::uint64_t dumpNanos{0};
+};
+
+struct FlightRingHeader {
+    std::uint32_t thread{0};
+    std::uint32_t reserved{0};
+    std::uint64_t head{0};  // 累计写入条数
+    std::uint64_t count{0}; // 本段记录条数（≤ 环容量）
+};
+
+/** 读回的转储 */
+struct FlightDump {
+    FlightDumpHeader header;
+    std::vector<FlightRecord> records; // 按环、环内按 seq 排列
+
+    /** ticks -> 距转储时刻的纳秒数（负数表示早于转储） */
+    double nanosBeforeDump(std::uint64_t ticks) const noexcept;
+};
+
+/**
+ * FlightRecorder：进程级、常开的崩溃现场记录器
+ * - 每个线程首次记录时领取一个定长环（2^14 条，1 MiB），单写者无锁：
+ *   记录按 8 个 64 位原子字 relaxed 写入 + 一次 release store，热路径不加锁、不分配
+ * - 单条开销实测约 20 ns（flight_bench，Release，虚拟机）：写记录约 4 ns，其余是被虚拟化截获的 rdtsc
+ * - 线程退出后环归还、可被新线程复用（保留旧记录直至被覆盖）
+ * - dump 可在任意线程调用，按字原子读取（不存在数据竞争）；与写者并发时被覆盖的记录按 seq 校验丢弃
+ * - installTerminateHandler：未捕获异常 / std::terminate 时先转储再交给原 handler
+ */
+class FlightRecorder {
+public:
+    static constexpr std::size_t kCapacity = std::size_t{1} << 14;
+    static constexpr std::size_t kMaxRings = 1024;
+    static constexpr std::uint32_t kVersion = 1;
+
+    static void record(FlightEvent type, OrderId orderId, Side side, std::int64_t qty, Money price) noexcept {
+        write(type, 0, static_cast<std::uint8_t>(side), orderId, 0, 0, qty, price.cents());
+    }
+
+    static void recordTrade(FlightEvent type, TradeId tradeId, OrderId buyOrderId, OrderId sellOrderId,
+                            std::int64_t qty, Money price) noexcept {
+        write(type, 0, 0, buyOrderId, sellOrderId, tradeId, qty, price.cents());
+    }
+
+    static void recordReject(OrderId orderId, ErrorCode code) noexcept {
+        write(FlightEvent::Rejected, static_cast<std::uint8_t>(code), 0, orderId, 0, 0, 0, 0);
+    }
+
+    static void recordTradeReject(TradeId tradeId, OrderId buyOrderId, OrderId sellOrderId,
+                                  ErrorCode code) noexcept {
+        write(FlightEvent::Rejected, static_cast<std::uint8_t>(code), 0, buyOrderId, sellOrderId, tradeId, 0, 0);
+    }
+
+    /** 关闭后 record 直接返回（默认开启） */
+    static void setEnabled(bool on) noexcept { enabled_.store(on, std::memory_order_relaxed); }
+    static bool enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    /** 所有线程环的快照（按环、环内按 seq） */
+    static std::vector<FlightRecord> snapshot();
+
+    /** 转储到文件；返回记录条数，失败抛 IOErrorException */
+    static std::size_t dump(const std::string& path);
+
+    /**
+     * 异常退出路径用：转储并在 stderr 报告结果；path 为空不做事
+     * - 转储失败只报告不抛，不掩盖原异常
+     */
+    static void dumpNoThrow(const std::string& path) noexcept;
+
+    /** 崩溃转储路径；再次调用覆盖路径，不重复挂接 */
+    static void installTerminateHandler(const std::string& path);
+
+    /** 读取转储文件（离线解码）；格式不符抛 ParseErrorException */
+    static FlightDump load(const std::string& path);
+
+    static std::uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::steady_clock::now().time_since_epoch())
+                                              .count());
+#endif
+    }
+
+private:
+    static constexpr std::size_t kWords = sizeof(FlightRecord) / sizeof(std::uint64_t);
+
+    /** 环内一条记录：读者与写者并发访问，按字存为原子量 */
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> words[kWords];
+
+        /** 各字按 FlightRecord 的内存布局排列；直接由寄存器写入，不经栈上拼装（避免 store forwarding 失败） */
+        void store(std::uint64_t ticks, std::uint64_t seq, std::uint8_t type, std::uint8_t error, std::uint8_t side,
+                   std::uint32_t thread, std::uint64_t orderId, std::uint64_t contraId, std::uint64_t tradeId,
+                   std::int64_t qty, std::int64_t price) noexcept {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            const std::uint64_t header = std::uint64_t{type} << 56 | std::uint64_t{error} << 48 |
+                                         std::uint64_t{side} << 40 | thread;
+#else
+            const std::uint64_t header = type | std::uint64_t{error} << 8 | std::uint64_t{side} << 16 |
+                                         std::uint64_t{thread} << 32;
+#endif
+            words[0].store(ticks, std::memory_order_relaxed);
+            words[1].store(seq, std::memory_order_relaxed);
+            words[2].store(header, std::memory_order_relaxed);
+            words[3].store(orderId, std::memory_order_relaxed);
+            words[4].store(contraId, std::memory_order_relaxed);
+            words[5].store(tradeId, std::memory_order_relaxed);
+            words[6].store(static_cast<std::uint64_t>(qty), std::memory_order_relaxed);
+            words[7].store(static_cast<std::uint64_t>(price), std::memory_order_relaxed);
+        }
+
+        FlightRecord load() const noexcept {
+            std::uint64_t w[kWords];
+            for (std::size_t i = 0; i < kWords; ++i) w[i] = words[i].load(std::memory_order_relaxed);
+            FlightRecord r;
+            std::memcpy(&r, w, sizeof(r));
+            return r;
+        }
+    };
+
+    struct alignas(64) Ring {
+        std::atomic<std::uint64_t> head{0};
+        std::atomic<bool> inUse{false};
+        std::uint32_t thread{0};
+        Slot records[kCapacity];
+    };
+
+    static void write(FlightEvent type, std::uint8_t error, std::uint8_t side, OrderId orderId,
+                      OrderId contraId, TradeId tradeId, std::int64_t qty, long long price) noexcept {
+        if (!enabled_.load(std::memory_order_relaxed)) return;
+        Ring* ring = tRing_ ? tRing_ : attachThread();
+        if (!ring) return;
+
+        const auto seq = ring->head.load(std::memory_order_relaxed);
+        const auto ticks = now();
+        // 与 copyRing 中的 acquire fence 配对：读者只要读到本条的任何一个字，随后读 head 必然 >= seq
+        std::atomic_thread_fence(std::memory_order_release);
+        ring->records[seq & (kCapacity - 1)].store(ticks, seq, static_cast<std::uint8_t>(type), error, side,
+                                                   ring->thread, orderId, contraId, tradeId, qty, price);
+        ring->head.store(seq + 1, std::memory_order_release);
+    }
+
+    /** 慢路径：领取 / 新建本线程的环；环数用尽返回 nullptr（该线程不记录） */
+    static Ring* attachThread() noexcept;
+
+    static inline std::atomic<bool> enabled_{true};
+    static inline thread_local Ring* tRing_ = nullptr;
+};
+
+} // namespace trade_sim
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "trade_sim/core/MatchingEngine.h"
+#include "trade_sim/io/Snapshot.h"
 
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -12,20 +15,50 @@ namespace trade_sim {
  * HistoryManager：保存交易历史
  * - userId -> vector<TradeId>
  * - trades_：tradeId -> Trade
+ * - 从快照恢复时，快照内的成交直接引用映射内存（base_），之后的成交照常记在内存里；
+ *   historyOf 先给出快照内的成交，再给出恢复后记录的成交
  */
 class HistoryManager {
 public:
+    HistoryManager() = default;
+
+    // baseSlots_ 可能指向自身的 rebuiltSlots_：禁止拷贝，移动时重新指向
+    HistoryManager(const HistoryManager&) = delete;
+    HistoryManager& operator=(const HistoryManager&) = delete;
+    HistoryManager(HistoryManager&& other) noexcept;
+    HistoryManager& operator=(HistoryManager&& other) noexcept;
+
     void record(const Trade& t, const AccountId& buyer, const AccountId& seller);
 
     std::vector<Trade> historyOf(const AccountId& user) const;
 
+    /** 成交总数（快照内 + 内存） */
+    std::size_t tradeCount() const noexcept;
+
     // 文件读写（训练点）
     void loadFromFile(const std::string& path);
     void saveToFile(const std::string& path) const;
 
+    /**
+     * 二进制快照：Trades / HistoryUsers / HistoryUserSlots / HistoryOffsets / HistoryEntries 五段
+     * - save 把快照内成交与内存成交合并写出（快照内的成交按原顺序整段复制）
+     * - load 要求当前为空；不拷贝成交，只持有映射
+     */
+    void saveSnapshot(SnapshotWriter& w) const;
+    void loadSnapshot(std::shared_ptr<const SnapshotView> view);
+
 private:
+    static constexpr std::uint32_t kNoUser = ~std::uint32_t{0};
+
+    /** 快照内用户下标，不存在返回 kNoUser */
+    std::uint32_t baseUser(const AccountId& user) const;
+
     std::unordered_map<TradeId, Trade> trades_;
     std::unordered_map<AccountId, std::vector<TradeId>> index_;
+
+    std::shared_ptr<const SnapshotView> base_;
+    SnapshotArray<SnapshotSlot> baseSlots_;  // 快照内索引，或 rebuiltSlots_
+    std::vector<SnapshotSlot> rebuiltSlots_; // 哈希探针不一致时按用户重建
 };
 
 } // namespace trade_sim
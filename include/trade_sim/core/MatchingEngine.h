@@ -3,6 +3,11 @@
 #include "trade_sim/common/Types.h"
 #include "trade_sim/order/Order.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace trade_sim {
@@ -17,17 +22,177 @@ struct Trade {
     Money price{0};
 };
 
+/** 撮合模式 */
+enum class MatchingMode {
+    Continuous, // 连续撮合：match 时立即撮合
+    Auction     // 集合竞价：match 只累积，uncross 时统一出清
+};
+
+/** 出清时逐笔结算的裁决（见 MatchingEngine::uncross） */
+enum class FillDecision {
+    Accept,    // 成交生效
+    RejectBuy, // 买方订单无法结算：整单移出簿，本笔不成交
+    RejectSell // 卖方订单无法结算：同上
+};
+
 /**
  * MatchingEngine：撮合引擎（简化版）
  * - 你可以先做“立即成交”假设
  * - 后续再扩展 order book
+ * - Auction 模式：订单按 symbol / 价位累积，uncross 时以单一出清价成交
  */
 class MatchingEngine {
 public:
+    MatchingEngine() = default;
+    explicit MatchingEngine(MatchingMode mode) : mode_(mode) {}
+
+    /**
+     * 出清逐笔结算回调：在扣减簿内数量之前调用
+     * buyLeaves / sellLeaves 为本笔之前双方的簿内剩余量（等于 t.qty 即本笔后全部成交）
+     */
+    using FillHandler = std::function<FillDecision(const Trade& t, std::int64_t buyLeaves, std::int64_t sellLeaves)>;
+
+    MatchingMode mode() const noexcept { return mode_; }
+
     std::vector<Trade> match(const Order& incoming);
 
+    /**
+     * 集合竞价出清（仅 Auction 模式）：
+     * - 出清价：成交量最大 -> 买卖不平衡量最小 -> 价格最低
+     * - 成交价统一为出清价；同侧按价格优先、时间优先分配
+     * - 复杂度 O(价位数 + 参与成交订单数)，不做订单两两比较
+     * - 未成交部分保留在簿内，参与下一次出清
+     * - settle 非空时每笔成交先交给 settle 裁决：被拒一侧整单移出簿，对手方数量原样保留并继续向后分配，
+     *   此时总成交量可能小于最大成交量；返回值只含已接受的成交，成交编号连续
+     * - settle 抛出的异常原样传播，此前已接受的成交保持生效
+     */
+    std::vector<Trade> uncross(const Symbol& sym, const FillHandler& settle = {});
+    std::vector<Trade> uncrossAll(const FillHandler& settle = {});
+
+    /** 撤单：从簿内移除剩余数量（Continuous 模式无簿，无操作），O(1) */
+    void cancel(const Order& order);
+
+    /**
+     * 改单：order 为改单前的状态，newQty 为新的订单总量
+     * - 同价且剩余量不增：就地修改，保持时间优先，O(1)
+     * - 改价或加量：原位置留墓碑，移到新价位队尾（失去时间优先）；Order 对象本身不重建
+     * - newQty 必须大于已成交量；失败不修改簿（强保证）
+     * - 返回 true 表示保持了时间优先；Continuous 模式无簿，恒为 true
+     */
+    bool amend(const Order& order, std::int64_t newQty, Money newLimit);
+
+    /** 当前累积、等待出清的订单数 */
+    std::size_t pendingCount(const Symbol& sym) const noexcept;
+    std::size_t restingCount() const noexcept { return restingCount_; }
+
+    /**
+     * 位置索引的稠密窗口：按订单号直接下标；跳得太远的新编号、重建时早于最近 kDenseSlack 个编号的在簿订单放 sparse
+     * - locationSlots 为当前窗口槽数（诊断 / 测试用）
+     */
+    static constexpr std::size_t kDenseSlack = std::size_t{1} << 20;
+    std::size_t locationSlots() const noexcept { return slots_.size(); }
+
+    /**
+     * 遍历簿内订单：f(OrderId, std::int64_t remaining)
+     * - 同一价位同一方向按时间优先顺序给出；按此顺序 restoreResting 可还原队列
+     */
+    template <class F>
+    void forEachResting(F&& f) const {
+        auto visitQueue = [&f](const AuctionQueue& q) {
+            for (auto i = q.head; i < q.entries.size(); ++i) {
+                if (q.entries[i].qty > 0) f(q.entries[i].id, q.entries[i].qty);
+            }
+        };
+        for (const auto& kv : auctions_) {
+            visitQueue(kv.second.market.buys);
+            visitQueue(kv.second.market.sells);
+            for (const auto& lv : kv.second.levels) {
+                visitQueue(lv.second.buys);
+                visitQueue(lv.second.sells);
+            }
+        }
+    }
+
+    /** 快照恢复（仅 Auction 模式）：以剩余数量 remaining 挂到队尾 */
+    void restoreResting(const Order& order, std::int64_t remaining);
+
+    /** 下一个成交编号（快照保存 / 恢复） */
+    TradeId nextTradeId() const noexcept { return nextTradeId_; }
+    void restoreNextTradeId(TradeId next);
+
 private:
+    /** 簿内订单；qty == 0 为墓碑（已撤/已成交/已移走），出清时跳过 */
+    struct AuctionEntry {
+        OrderId id{0};
+        std::int64_t qty{0}; // 剩余数量
+    };
+
+    /**
+     * 同价位同方向的 FIFO 队列（顺序即时间优先）
+     * - entries[0, head) 已出队；entries[i] 的序号为 base + i，压缩前缀时序号不变
+     */
+    struct AuctionQueue {
+        std::vector<AuctionEntry> entries;
+        std::size_t head{0};
+        std::uint64_t base{0};
+        std::size_t live{0};
+    };
+
+    struct AuctionLevel {
+        long long price{0}; // 市价档为 0
+        std::int64_t buyQty{0};
+        std::int64_t sellQty{0};
+        AuctionQueue buys;
+        AuctionQueue sells;
+    };
+
+    struct AuctionBook {
+        std::map<long long, AuctionLevel> levels; // priceCents -> level
+        AuctionLevel market;                      // 市价单：买视为 +inf，卖视为 0
+        std::size_t orderCount{0};
+    };
+
+    /**
+     * 订单位置：成交时不清（出清热路径零额外开销），查找时校验序号/id 识别过期项
+     * - 价位只在重建时删除；重建只为在簿订单刷新 epoch，旧 epoch 的位置不再解引用 level，不会悬空
+     */
+    struct Location {
+        AuctionLevel* level{nullptr};
+        std::uint64_t seq : 62;
+        std::uint64_t buy : 1;
+        std::uint64_t market : 1;
+        std::uint64_t epoch{0};
+        Location() : seq(0), buy(1), market(0) {}
+    };
+
+    std::vector<Trade> uncrossBook(const Symbol& sym, AuctionBook& book, const FillHandler& settle);
+
+    /** 以数量 qty 挂入簿内（match / restoreResting 共用） */
+    void rest(const Order& order, std::int64_t qty);
+
+    /** 有效位置返回对应条目，过期或不存在返回 nullptr */
+    AuctionEntry* resting(OrderId id, Location** loc);
+    Location* findLocation(OrderId id) noexcept;
+    /** 取 id 的位置槽（必要时扩展稠密窗口），供新挂入的订单写入 */
+    Location& locationSlot(OrderId id);
+    void clearLocation(OrderId id) noexcept;
+    /** 挂到价位队尾并累加汇总，返回新位置 */
+    Location enqueue(AuctionBook& book, OrderId id, std::int64_t qty, long long price, bool buy, bool market);
+    static void compactHead(AuctionQueue& q);
+    void maybeRebuildIndex();
+
+    MatchingMode mode_{MatchingMode::Continuous};
     TradeId nextTradeId_{1};
+    std::unordered_map<Symbol, AuctionBook> auctions_;
+    // 位置索引：订单号由 OrderManager 顺序分配，按 id 直接下标，挂单不做哈希插入；
+    // 窗口为 [slotBase_, slotBase_ + slots_.size())，重建时剪掉已无在簿订单的前缀
+    std::vector<Location> slots_;
+    OrderId slotBase_{0};
+    std::unordered_map<OrderId, Location> sparse_;
+    std::size_t restingCount_{0}; // 所有簿内有效订单数
+    std::size_t tombstones_{0};   // 撤单/改单留下的墓碑数（重建时清零）
+    std::size_t retired_{0};      // 出清吃完 / 被拒的条目数（重建时清零）
+    std::uint64_t epoch_{1};      // 每次重建加一
 };
 
 } // namespace trade_sim
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "trade_sim/core/AccountManager.h"
+#include "trade_sim/core/OrderManager.h"
+#include "trade_sim/core/TradeExecutor.h"
+#include "trade_sim/io/BinaryProtocol.h"
+
+#include <vector>
+
+namespace trade_sim {
+
+/**
+ * OrderEntryHandler：二进制订单消息 -> TradeExecutor
+ * - NewOrder：分配 OrderId，经 OrderFactory 建单后 submitAndProcess
+ * - Cancel：TradeExecutor::cancel
+ * - Amend：TradeExecutor::amend（同价减量保持时间优先）
+ * - Cancel / Amend 的 account 必须是订单所属账户，否则按订单不存在拒绝（NotFound）
+ * - Deposit：账户不存在时以该金额开户，否则入金；symbol 非空且 qty > 0 时另存入该 symbol 持仓
+ * - 每条消息产生 Accepted/Cancelled/Deposited 或 Rejected 回报，成交另出 Trade 回报
+ *   （订单全部成交的那一笔带 kTradeBuyFilled / kTradeSellFilled）
+ * - 业务异常转为 Rejected（error = ErrorCode），不向外抛出
+ */
+class OrderEntryHandler {
+public:
+    OrderEntryHandler(AccountManager& am, OrderManager& om, TradeExecutor& exec)
+        : accounts_(am), orders_(om), exec_(exec) {}
+
+    void handle(const WireMessage& msg, std::vector<WireReport>& out);
+
+    /**
+     * 集合竞价出清（逐笔结算），不抛出业务异常；回报 clientSeq = 0：
+     * - 已结算的成交：Trade
+     * - 因资金 / 持仓不足被整单拒绝、移出簿的订单：Rejected（orderId = 该订单，error = ErrorCode）
+     */
+    void uncrossAll(std::vector<WireReport>& out);
+
+private:
+    AccountManager& accounts_;
+    OrderManager& orders_;
+    TradeExecutor& exec_;
+
+    void onNewOrder(const WireMessage& msg, std::vector<WireReport>& out);
+    void onCancel(const WireMessage& msg, std::vector<WireReport>& out);
+    void onAmend(const WireMessage& msg, std::vector<WireReport>& out);
+    void onDeposit(const WireMessage& msg, std::vector<WireReport>& out);
+    /** 目标订单不属于 msg.account 时抛 NotFoundException */
+    void checkOwner(const WireMessage& msg) const;
+    void reportTrades(std::uint64_t clientSeq, const std::vector<Trade>& trades, std::vector<WireReport>& out) const;
+};
+
+} // namespace trade_sim
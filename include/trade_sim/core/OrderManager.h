@@ -3,6 +3,7 @@
 #include "trade_sim/common/Types.h"
 #include "trade_sim/order/Order.h"
 
+#include <cstddef>
 #include <memory>
 #include <unordered_map>
 
@@ -21,11 +22,33 @@ public:
     const Order& get(OrderId id) const;
 
     OrderStatus status(OrderId id) const;
+
+    /** 撤单：仅 Pending / PartiallyFilled 可撤，否则抛 InvalidState（已成交 / 已撤 / 已拒） */
     void cancel(OrderId id);
 
+    /** 成交后更新状态：Pending / PartiallyFilled -> complete ? Filled : PartiallyFilled */
+    void fill(OrderId id, bool complete);
+
+    /** 出清时无法结算、已被撮合簿整单移出：Pending / PartiallyFilled -> Rejected */
+    void reject(OrderId id);
+
+    /**
+     * 改单：就地修改数量 / 限价，订单对象与状态不变
+     * - 仅 Pending / PartiallyFilled 可改；Market 的 newLimit 必须为 0
+     * - 强保证：校验全部通过后才修改
+     */
+    void amend(OrderId id, std::int64_t newQty, Money newLimit);
+
     // 裸指针入口（训练点），内部立刻接管为 unique_ptr
     void submitRaw(Order* rawOrder);
 
+    std::size_t size() const noexcept { return orders_.size(); }
+
+    /** 快照恢复：按原状态入库；下一个订单号只能前移 */
+    void restore(std::unique_ptr<Order> order, OrderStatus status);
+    OrderId peekNextId() const noexcept { return next_; }
+    void restoreNextId(OrderId next);
+
 private:
     OrderId next_{1};
     std::unordered_map<OrderId, std::unique_ptr<Order>> orders_;
@@ -4,9 +4,16 @@
 #include "trade_sim/core/HistoryManager.h"
 #include "trade_sim/core/MatchingEngine.h"
 #include "trade_sim/core/OrderManager.h"
+#include "trade_sim/core/ValuationEngine.h"
 
 namespace trade_sim {
 
+/** 出清时无法结算、被整单拒绝的订单 */
+struct SettlementReject {
+    OrderId orderId{0};
+    ErrorCode code{ErrorCode::InvalidState};
+};
+
 /**
  * TradeExecutor：业务编排层
  * 典型流程：
@@ -17,14 +24,51 @@ public:
     TradeExecutor(AccountManager& am, OrderManager& om, MatchingEngine& me, HistoryManager& hm)
         : accounts_(am), orders_(om), engine_(me), history_(hm) {}
 
-    void submitAndProcess(std::unique_ptr<Order> order);
+    /** 返回值：本次已结算的成交 */
+    std::vector<Trade> submitAndProcess(std::unique_ptr<Order> order);
+
+    /** 撤单：OrderManager 标记 Cancelled，并从撮合簿内移除 */
+    void cancel(OrderId id);
+
+    /**
+     * 改单：撮合簿与 OrderManager 同步修改（先做全部校验，任一失败两边都不变）
+     * 返回 true 表示保持了时间优先
+     */
+    bool amend(OrderId id, std::int64_t newQty, Money newLimit);
+
+    /**
+     * 集合竞价：出清时逐笔结算 + 记录历史，返回已结算的成交
+     * - 某笔因资金 / 持仓不足无法结算时只拒绝责任方订单（状态 Rejected、移出簿），
+     *   对手方留簿继续分配，其余成交照常结算；不抛出结算异常
+     * - rejected 非空时追加被拒订单
+     */
+    std::vector<Trade> uncrossAndProcess(const Symbol& sym, std::vector<SettlementReject>* rejected = nullptr);
+    std::vector<Trade> uncrossAllAndProcess(std::vector<SettlementReject>* rejected = nullptr);
+
+    /**
+     * 入金存入持仓：加到账户上，并在挂接了估值时导入（按当前标记价计成本）
+     * - 挂接估值后库存变动须经此处，直接调用 Account::addPosition 估值引擎看不见
+     */
+    void depositPosition(const AccountId& id, const Symbol& sym, std::int64_t qty);
+
+    /**
+     * 可选：挂接增量估值，结算成功后同步更新（不持有所有权，nullptr 解除）
+     * - 挂接时把 AccountManager 中的现有持仓按当前标记价导入（见 ValuationEngine::importPosition），
+     *   因此引擎须为空（positionCount() == 0），否则抛 InvalidState 且不挂接
+     */
+    void attachValuation(ValuationEngine* valuation);
 
 private:
     AccountManager& accounts_;
     OrderManager& orders_;
     MatchingEngine& engine_;
     HistoryManager& history_;
+    ValuationEngine* valuation_{nullptr};
 
+    void settle(const std::vector<Trade>& trades);
+    FillDecision settleFill(const Trade& t, std::int64_t buyLeaves, std::int64_t sellLeaves,
+                            std::vector<SettlementReject>* rejected);
+    void recordSettled(const Trade& t);
     void applyTradeToAccounts(const Trade& t); // TODO：扣钱/加仓/异常处理
 };
 
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "trade_sim/common/Types.h"
+#include "trade_sim/core/MatchingEngine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace trade_sim {
+
+/** 账户估值快照 */
+struct AccountValuation {
+    Money realizedPnl{0};
+    Money unrealizedPnl{0}; // marketValue - 持仓成本
+    Money marketValue{0};   // Σ qty * 标记价
+    Money grossExposure{0}; // Σ |qty| * 标记价
+};
+
+/**
+ * ValuationEngine：增量盯市（mark-to-market）
+ * - 持仓按平均成本法记成本（可为空头，成本与数量同号），平仓时结转已实现盈亏
+ * - 成交：O(1) 更新买卖双方持仓与账户汇总
+ * - 行情：通过 symbol -> 持仓槽 索引，只更新该 symbol 的持有人（qty 非 0 的槽，归零即移出）
+ * - 成交不改变标记价；标记价只由 onPrice 推进（未报价的 symbol 按 0 计）
+ * - 持仓槽按列存储（SoA），revalueAll 为日终全量重估的顺序扫描
+ */
+class ValuationEngine {
+public:
+    void onTrade(const Trade& t, const AccountId& buyer, const AccountId& seller);
+
+    /**
+     * 单边持仓变动（成交的一侧，或导入已有持仓时用成本价建仓）
+     * - 卖出超过已知持仓的部分记为空头，按成交价计成本；买回空头时结转已实现盈亏
+     * - 估值引擎只看见经它的成交：已有库存须先导入（importPosition 或按成本价 applyFill），否则卖出即记为空头
+     */
+    void applyFill(const AccountId& account, const Symbol& sym, std::int64_t deltaQty, Money price);
+
+    /** 导入库存（已有持仓 / 入金存入的持仓）：按该 symbol 当前标记价计成本（未报价为 0），导入时未实现盈亏为 0 */
+    void importPosition(const AccountId& account, const Symbol& sym, std::int64_t qty);
+
+    void onPrice(const Symbol& sym, Money last);
+
+    /** 日终全量重估：按当前标记价重算所有账户的市值与敞口 */
+    void revalueAll();
+
+    AccountValuation valuationOf(const AccountId& id) const;
+    Money lastPrice(const Symbol& sym) const noexcept;
+    std::size_t positionCount() const noexcept { return posQty_.size(); }
+    /** 该 symbol 的持有人数（qty 非 0 的持仓槽） */
+    std::size_t holderCount(const Symbol& sym) const noexcept;
+
+private:
+    std::uint32_t accountIndex(const AccountId& id);
+    std::uint32_t symbolIndex(const Symbol& sym);
+    std::uint32_t slotIndex(std::uint32_t account, std::uint32_t symbol);
+    void addHolder(std::uint32_t slot);
+    void removeHolder(std::uint32_t slot) noexcept;
+
+    static constexpr std::uint32_t kNotHeld = ~std::uint32_t{0};
+
+    std::unordered_map<AccountId, std::uint32_t> accountIdx_;
+    std::unordered_map<Symbol, std::uint32_t> symbolIdx_;
+    std::unordered_map<std::uint64_t, std::uint32_t> slotIdx_; // (account << 32 | symbol) -> slot
+
+    // symbol 列
+    std::vector<long long> lastPx_;
+    std::vector<std::vector<std::uint32_t>> holders_; // symbol -> qty 非 0 的持仓槽
+
+    // 持仓槽列
+    std::vector<std::uint32_t> posAccount_;
+    std::vector<std::uint32_t> posSymbol_;
+    std::vector<std::int64_t> posQty_;
+    std::vector<long long> posCost_; // 持仓总成本（分）
+    std::vector<std::uint32_t> posHolder_; // 在 holders_[symbol] 中的下标，kNotHeld 表示 qty 为 0
+
+    // 账户列
+    std::vector<long long> realized_;
+    std::vector<long long> cost_;
+    std::vector<long long> marketValue_;
+    std::vector<long long> gross_;
+};
+
+} // namespace trade_sim
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "trade_sim/common/Exceptions.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace trade_sim {
+
+/**
+ * 二进制订单协议（定长帧，本机字节序，按小端主机设计）
+ * - 输入：WireMessage，64 字节/条（NewOrder / Cancel / Deposit / Amend）
+ * - 输出：WireReport，56 字节/条（执行回报）
+ * - 字符串字段定长，不足补 '\0'；写满时不带结尾 '\0'
+ */
+enum class MsgType : std::uint8_t { NewOrder = 1, Cancel = 2, Deposit = 3, Amend = 4 };
+
+enum class ReportType : std::uint8_t { Accepted = 1, Rejected = 2, Trade = 3, Cancelled = 4, Deposited = 5, Amended = 6 };
+
+struct WireMessage {
+    std::uint8_t type{0};       // MsgType
+    std::uint8_t side{0};       // 0 = Buy, 1 = Sell
+    std::uint8_t kind{0};       // 0 = Market, 1 = Limit
+    std::uint8_t reserved[5]{};
+    std::uint64_t clientSeq{0}; // 客户端序号，回报原样带回
+    std::uint64_t orderId{0};   // Cancel / Amend：目标订单
+    std::int64_t qty{0};        // NewOrder / Amend：订单总量；Deposit：存入 symbol 的持仓（可为 0）
+    std::int64_t amount{0};     // NewOrder / Amend：限价（分）；Deposit：金额（分）
+    char account[16]{};         // Cancel / Amend：须为订单所属账户
+    char symbol[8]{};
+};
+
+struct WireReport {
+    std::uint8_t type{0};       // ReportType
+    std::uint8_t error{0};      // Rejected：ErrorCode；Amended：1 = 保持时间优先；Trade：kTrade*Filled 位
+    std::uint8_t reserved[6]{};
+    std::uint64_t clientSeq{0};
+    std::uint64_t orderId{0};   // Trade：买方订单
+    std::uint64_t contraId{0};  // Trade：卖方订单
+    std::int64_t qty{0};
+    std::int64_t price{0};      // Trade：成交价（分）；Deposited：余额（分）
+    std::uint64_t tradeId{0};   // Trade：成交编号
+};
+
+/** Trade 回报 error 位：该侧订单由本笔全部成交（之后不会再有它的回报） */
+constexpr std::uint8_t kTradeBuyFilled = 1;
+constexpr std::uint8_t kTradeSellFilled = 2;
+
+static_assert(sizeof(WireMessage) == 64, "WireMessage must be 64 bytes");
+static_assert(sizeof(WireReport) == 56, "WireReport must be 56 bytes");
+static_assert(std::is_trivially_copyable<WireMessage>::value, "WireMessage must be trivially copyable");
+static_assert(std::is_trivially_copyable<WireReport>::value, "WireReport must be trivially copyable");
+
+/**
+ * 直接在读缓冲区上解码：memcpy 到定长结构（编译为普通 load，无中间字符串/拷贝缓冲）
+ */
+inline WireMessage decodeMessage(const char* p) noexcept {
+    WireMessage m;
+    std::memcpy(&m, p, sizeof(m));
+    return m;
+}
+
+inline void encodeMessage(const WireMessage& m, char* out) noexcept {
+    std::memcpy(out, &m, sizeof(m));
+}
+
+inline WireReport decodeReport(const char* p) noexcept {
+    WireReport r;
+    std::memcpy(&r, p, sizeof(r));
+    return r;
+}
+
+inline void encodeReport(const WireReport& r, char* out) noexcept {
+    std::memcpy(out, &r, sizeof(r));
+}
+
+/** 定长字段 -> std::string（遇 '\0' 截断） */
+template <std::size_t N>
+std::string wireString(const char (&field)[N]) {
+    const void* end = std::memchr(field, '\0', N);
+    return std::string(field, end ? static_cast<const char*>(end) - field : N);
+}
+
+/** std::string -> 定长字段；超长抛 InvalidArgumentException */
+template <std::size_t N>
+void setWireString(char (&field)[N], const std::string& s) {
+    if (s.size() > N) throw InvalidArgumentException("wire string too long: " + s);
+    std::memset(field, 0, N);
+    std::memcpy(field, s.data(), s.size());
+}
+
+} // namespace trade_sim
@@ -0,0 +1,250 @@
+#pragma once
+
+#include "trade_sim/common/Exceptions.h"
+#include "trade_sim/common/Types.h"
+#include "trade_sim/model/SymbolTable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace trade_sim {
+
+class AccountManager;
+class HistoryManager;
+class MatchingEngine;
+class OrderManager;
+
+/**
+ * 二进制快照格式（本机字节序，版本化，位置无关）
+ * - 文件 = SnapshotHeader + 若干段（section），段按 64 字节对齐，段内为定长记录数组
+ * - 记录之间只用下标 / 偏移互相引用，不含指针：可直接 mmap 使用，也可整段拷贝
+ * - 字符串统一放在 Strings 段，以 SnapshotString{偏移, 长度} 引用
+ * - symbol 以快照内编号引用 Symbols 段，加载时映射到进程内 SymbolTable 编号
+ */
+constexpr char kSnapshotMagic[8] = {'T', 'S', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr std::uint32_t kSnapshotVersion = 1;
+constexpr std::size_t kSnapshotAlign = 64;
+
+enum class SnapshotSection : std::uint32_t {
+    Strings = 0,      // char
+    Symbols,          // SnapshotString，下标即快照内 symbol 编号
+    Accounts,         // SnapshotAccount，顺序即 AccountManager 内部顺序
+    Positions,        // SnapshotPosition，按账户连续存放
+    AccountSlots,     // SnapshotSlot，AccountManager 开放寻址索引原样
+    Orders,           // SnapshotOrder，簿内订单，同价位同方向按时间优先
+    Trades,           // SnapshotTrade
+    HistoryUsers,     // SnapshotString
+    HistoryUserSlots, // SnapshotSlot：用户 id 哈希 -> HistoryUsers 下标
+    HistoryOffsets,   // std::uint64_t[用户数 + 1]：用户 u 的成交为 HistoryEntries[offsets[u], offsets[u+1])
+    HistoryEntries,   // std::uint32_t：Trades 下标，按记录顺序
+    Count
+};
+
+constexpr std::size_t kSnapshotSectionCount = static_cast<std::size_t>(SnapshotSection::Count);
+
+struct SnapshotSectionEntry {
+    std::uint64_t offset{0}; // 距文件头字节数
+    std::uint64_t count{0};  // 记录条数
+};
+
+struct SnapshotHeader {
+    char magic[8]{};
+    std::uint32_t version{0};
+    std::uint32_t headerBytes{0};
+    std::uint64_t fileBytes{0};
+    std::uint64_t hashProbe{0};   // 写入时 std::hash 的探针值；不一致时索引段需重建
+    std::uint64_t nextOrderId{0};
+    std::uint64_t nextTradeId{0};
+    std::uint32_t matchingMode{0}; // MatchingMode
+    std::uint32_t reserved{0};
+    SnapshotSectionEntry sections[kSnapshotSectionCount]{};
+};
+
+struct SnapshotString {
+    std::uint32_t offset{0};
+    std::uint32_t length{0};
+};
+
+struct SnapshotAccount {
+    SnapshotString id;
+    std::int64_t balance{0};         // 分
+    std::uint32_t firstPosition{0};
+    std::uint32_t positionCount{0};
+};
+
+struct SnapshotPosition {
+    std::uint32_t symbol{0};
+    std::uint32_t reserved{0};
+    std::int64_t qty{0};
+};
+
+struct SnapshotSlot {
+    std::uint32_t hash{0};
+    std::uint32_t index{~std::uint32_t{0}}; // 空槽为全 1
+};
+
+struct SnapshotOrder {
+    std::uint64_t id{0};
+    SnapshotString account;
+    std::uint32_t symbol{0};
+    std::uint8_t side{0};   // Side
+    std::uint8_t kind{0};   // OrderKind
+    std::uint8_t status{0}; // OrderStatus
+    std::uint8_t reserved{0};
+    std::int64_t qty{0};       // 订单总量
+    std::int64_t remaining{0}; // 簿内剩余
+    std::int64_t limit{0};     // 分；Market 为 0
+};
+
+struct SnapshotTrade {
+    std::uint64_t tradeId{0};
+    std::uint64_t buyOrderId{0};
+    std::uint64_t sellOrderId{0};
+    std::int64_t qty{0};
+    std::int64_t price{0}; // 分
+    std::uint32_t symbol{0};
+    std::uint32_t reserved{0};
+};
+
+static_assert(sizeof(SnapshotHeader) == 56 + 16 * kSnapshotSectionCount, "SnapshotHeader layout changed");
+static_assert(sizeof(SnapshotAccount) == 24, "SnapshotAccount must be 24 bytes");
+static_assert(sizeof(SnapshotPosition) == 16, "SnapshotPosition must be 16 bytes");
+static_assert(sizeof(SnapshotSlot) == 8, "SnapshotSlot must be 8 bytes");
+static_assert(sizeof(SnapshotOrder) == 48, "SnapshotOrder must be 48 bytes");
+static_assert(sizeof(SnapshotTrade) == 48, "SnapshotTrade must be 48 bytes");
+static_assert(std::is_trivially_copyable<SnapshotHeader>::value, "SnapshotHeader must be trivially copyable");
+
+/** 快照内开放寻址索引使用的哈希（与 AccountManager 一致：std::hash 低 32 位） */
+inline std::uint32_t snapshotHash(std::string_view s) noexcept {
+    return static_cast<std::uint32_t>(std::hash<std::string_view>{}(s));
+}
+
+/** 当前进程 std::hash 的探针值：与快照头不一致时，快照内的索引段不可直接使用 */
+inline std::uint64_t snapshotHashProbe() noexcept {
+    return std::hash<std::string_view>{}(std::string_view("trade_sim snapshot hash probe"));
+}
+
+/** 段内记录的只读视图（指向映射内存） */
+template <class T>
+struct SnapshotArray {
+    const T* data{nullptr};
+    std::size_t size{0};
+
+    const T& operator[](std::size_t i) const noexcept { return data[i]; }
+    const T* begin() const noexcept { return data; }
+    const T* end() const noexcept { return data + size; }
+};
+
+/**
+ * SnapshotWriter：顺序写快照（段写完即落盘，内存里只保留字符串池）
+ * - 先写临时文件，commit 时回填文件头并改名，旧快照在改名前保持完整
+ * - 每段 begin -> append... -> end；段可按任意顺序写，未写的段为空
+ */
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::string path);
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    SnapshotString addString(std::string_view s);
+
+    void begin(SnapshotSection section, std::size_t recordBytes);
+    void append(const void* data, std::size_t bytes);
+    void end();
+
+    template <class T>
+    void append(const T& record) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot records must be trivially copyable");
+        append(&record, sizeof(T));
+    }
+
+    template <class T>
+    void writeSection(SnapshotSection section, const T* data, std::size_t count) {
+        begin(section, sizeof(T));
+        append(data, sizeof(T) * count);
+        end();
+    }
+
+    SnapshotHeader& header() noexcept { return header_; }
+
+    /** 写入字符串池与文件头，fsync 后改名为目标路径 */
+    void commit();
+
+private:
+    void writeRaw(const void* data, std::size_t bytes);
+
+    std::string path_;
+    std::string tmpPath_;
+    std::FILE* file_{nullptr};
+    std::uint64_t offset_{0};
+    SnapshotHeader header_;
+    std::vector<char> strings_;
+    int current_{-1};
+    std::size_t recordBytes_{0};
+    std::uint64_t sectionBytes_{0};
+};
+
+/**
+ * SnapshotView：只读映射的快照（POSIX 上为 mmap，其它平台整文件读入）
+ * - open 只校验文件头与段边界，不扫描记录：打开耗时与快照大小无关
+ * - 字符串 / 下标在使用处做边界检查，越界抛 ParseErrorException
+ */
+class SnapshotView {
+public:
+    static std::shared_ptr<const SnapshotView> open(const std::string& path);
+    ~SnapshotView();
+
+    SnapshotView(const SnapshotView&) = delete;
+    SnapshotView& operator=(const SnapshotView&) = delete;
+
+    const SnapshotHeader& header() const noexcept { return header_; }
+    bool hashCompatible() const noexcept { return header_.hashProbe == snapshotHashProbe(); }
+
+    template <class T>
+    SnapshotArray<T> section(SnapshotSection s) const noexcept {
+        const auto& e = header_.sections[static_cast<std::size_t>(s)];
+        return SnapshotArray<T>{reinterpret_cast<const T*>(base_ + e.offset), static_cast<std::size_t>(e.count)};
+    }
+
+    std::string_view string(SnapshotString s) const;
+
+    /** 快照内 symbol 编号 -> 进程内 SymbolTable 编号（open 时已全部驻留） */
+    SymbolTable::Code symbol(std::uint32_t snapshotCode) const;
+
+private:
+    SnapshotView() = default;
+    void validate(const std::string& path);
+
+    const char* base_{nullptr};
+    std::size_t bytes_{0};
+    bool mapped_{false};
+    std::vector<char> buffer_; // 非 POSIX 平台的整文件缓冲
+    SnapshotHeader header_;
+    std::vector<SymbolTable::Code> symbols_;
+};
+
+/**
+ * Snapshot：整机状态的保存 / 恢复
+ * - 覆盖账户与持仓、簿内订单、成交历史，以及下一个订单号 / 成交编号
+ * - 恢复要求各管理器为空；账户整段拷贝进 AccountManager，成交历史直接引用映射内存
+ * - 恢复为全有或全无：先恢复到暂存对象再整体移交，失败（含订单重号、引用不存在的账户）时管理器保持为空
+ */
+class Snapshot {
+public:
+    static void save(const std::string& path, const AccountManager& am, const OrderManager& om,
+                     const MatchingEngine& me, const HistoryManager& hm);
+
+    static std::shared_ptr<const SnapshotView> load(const std::string& path, AccountManager& am, OrderManager& om,
+                                                    MatchingEngine& me, HistoryManager& hm);
+};
+
+} // namespace trade_sim
@@ -3,8 +3,10 @@
 #include "trade_sim/common/Exceptions.h"
 #include "trade_sim/common/Types.h"
 #include "trade_sim/model/Asset.h"
+#include "trade_sim/model/PositionBook.h"
+#include "trade_sim/model/SymbolTable.h"
 
-#include <unordered_map>
+#include <cstddef>
 #include <utility>
 
 namespace trade_sim {
@@ -12,7 +14,7 @@ namespace trade_sim {
 /**
  * Account：账户与持仓。
  * - balance_：现金余额
- * - positions_：symbol -> qty
+ * - positions_：symbol -> qty（symbol 驻留为编号，小缓冲内联存放，qty 为 0 不占位）
  */
 class Account {
 public:
@@ -36,22 +38,43 @@ public:
     }
 
     std::int64_t positionOf(const Symbol& sym) const {
-        auto it = positions_.find(sym);
-        return it == positions_.end() ? 0 : it->second;
+        const auto code = SymbolTable::find(sym);
+        return code == SymbolTable::npos ? 0 : positions_.get(code);
     }
 
     void addPosition(const Symbol& sym, std::int64_t deltaQty) {
-        const auto next = positionOf(sym) + deltaQty;
+        const auto code = SymbolTable::intern(sym);
+        const auto next = positions_.get(code) + deltaQty;
         if (next < 0) {
             throw TradeSimException(ErrorCode::InsufficientPosition, "insufficient position");
         }
-        positions_[sym] = next;
+        positions_.set(code, next);
+    }
+
+    /** 非零持仓个数 */
+    std::size_t positionCount() const noexcept { return positions_.size(); }
+
+    /** f(const Symbol&, std::int64_t qty)，只遍历非零持仓，顺序不保证 */
+    template <class F>
+    void forEachPosition(F&& f) const {
+        positions_.forEach([&f](SymbolTable::Code code, std::int64_t qty) { f(SymbolTable::name(code), qty); });
+    }
+
+    /** 按 symbol 编号遍历 / 恢复（快照用，免去按名字查驻留表） */
+    template <class F>
+    void forEachPositionCode(F&& f) const {
+        positions_.forEach(f);
+    }
+
+    void restorePosition(SymbolTable::Code code, std::int64_t qty) {
+        if (qty < 0) throw TradeSimException(ErrorCode::InsufficientPosition, "insufficient position");
+        positions_.set(code, qty);
     }
 
 private:
     AccountId id_;
     Money balance_{0};
-    std::unordered_map<Symbol, std::int64_t> positions_;
+    PositionBook positions_;
 };
 
 } // namespace trade_sim
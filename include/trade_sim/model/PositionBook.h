@@ -0,0 +1,126 @@
+#pragma once
+
+#include "trade_sim/model/SymbolTable.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace trade_sim {
+
+/**
+ * PositionBook：小缓冲持仓表（symbol 编号 -> qty）
+ * - 前 kInline 个持仓内联存放，不分配内存；超出后整体转入按编号排序的平铺数组
+ * - qty 归零即删除，散户账户通常只有 0~2 个持仓
+ * - 内联时占 40 字节（原 unordered_map 为 56 字节 + 每个持仓一个堆节点）
+ */
+class PositionBook {
+public:
+    using Code = SymbolTable::Code;
+    static constexpr std::size_t kInline = 2;
+
+    PositionBook() = default;
+    PositionBook(PositionBook&&) noexcept = default;
+    PositionBook& operator=(PositionBook&&) noexcept = default;
+
+    PositionBook(const PositionBook& rhs)
+        : size_(rhs.size_),
+          spill_(rhs.spill_ ? std::make_unique<std::vector<Entry>>(*rhs.spill_) : nullptr) {
+        std::copy(rhs.codes_, rhs.codes_ + kInline, codes_);
+        std::copy(rhs.qty_, rhs.qty_ + kInline, qty_);
+    }
+
+    PositionBook& operator=(const PositionBook& rhs) {
+        if (this != &rhs) {
+            PositionBook tmp(rhs);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    std::size_t size() const noexcept { return spill_ ? spill_->size() : size_; }
+
+    std::int64_t get(Code code) const noexcept {
+        if (spill_) {
+            auto it = lowerBound(*spill_, code);
+            return it != spill_->end() && it->first == code ? it->second : 0;
+        }
+        for (std::uint32_t i = 0; i < size_; ++i) {
+            if (codes_[i] == code) return qty_[i];
+        }
+        return 0;
+    }
+
+    /** qty == 0 删除该持仓；强异常保证（仅转入平铺数组时可能分配失败） */
+    void set(Code code, std::int64_t qty) {
+        if (spill_) {
+            auto& v = *spill_;
+            auto it = lowerBound(v, code);
+            if (it != v.end() && it->first == code) {
+                if (qty == 0) v.erase(it);
+                else it->second = qty;
+            } else if (qty != 0) {
+                v.insert(it, Entry{code, qty});
+            }
+            return;
+        }
+
+        for (std::uint32_t i = 0; i < size_; ++i) {
+            if (codes_[i] != code) continue;
+            if (qty != 0) {
+                qty_[i] = qty;
+            } else {
+                --size_;
+                codes_[i] = codes_[size_];
+                qty_[i] = qty_[size_];
+            }
+            return;
+        }
+        if (qty == 0) return;
+        if (size_ < kInline) {
+            codes_[size_] = code;
+            qty_[size_] = qty;
+            ++size_;
+            return;
+        }
+
+        // 内联已满：整体转入平铺数组
+        auto v = std::make_unique<std::vector<Entry>>();
+        v->reserve(kInline * 2 + 1);
+        for (std::uint32_t i = 0; i < size_; ++i) v->emplace_back(codes_[i], qty_[i]);
+        v->emplace_back(code, qty);
+        std::sort(v->begin(), v->end());
+        spill_ = std::move(v);
+        size_ = 0;
+    }
+
+    /** f(Code, std::int64_t qty)，顺序不保证 */
+    template <class F>
+    void forEach(F&& f) const {
+        if (spill_) {
+            for (const auto& e : *spill_) f(e.first, e.second);
+            return;
+        }
+        for (std::uint32_t i = 0; i < size_; ++i) f(codes_[i], qty_[i]);
+    }
+
+private:
+    using Entry = std::pair<Code, std::int64_t>;
+
+    static std::vector<Entry>::iterator lowerBound(std::vector<Entry>& v, Code code) noexcept {
+        return std::lower_bound(v.begin(), v.end(), code, [](const Entry& e, Code c) { return e.first < c; });
+    }
+    static std::vector<Entry>::const_iterator lowerBound(const std::vector<Entry>& v, Code code) noexcept {
+        return std::lower_bound(v.begin(), v.end(), code, [](const Entry& e, Code c) { return e.first < c; });
+    }
+
+    Code codes_[kInline]{};
+    std::uint32_t size_{0};
+    std::int64_t qty_[kInline]{};
+    std::unique_ptr<std::vector<Entry>> spill_;
+};
+
+} // namespace trade_sim
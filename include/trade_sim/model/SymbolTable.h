@@ -0,0 +1,82 @@
+#pragma once
+
+#include "trade_sim/common/Exceptions.h"
+#include "trade_sim/common/Types.h"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace trade_sim {
+
+/**
+ * SymbolTable：进程内 symbol 驻留表（Symbol <-> 32 位编号）
+ * - 持仓只存编号，避免每个持仓各持一份 std::string
+ * - 编号只增不删；进程内所有节点（如同进程的主备）共用，可多线程调用：
+ *   查询持读锁，只有首次驻留新 symbol 时持写锁
+ * - name 返回的引用在进程内一直有效（deque 尾插不移动已有元素）
+ */
+class SymbolTable {
+public:
+    using Code = std::uint32_t;
+    static constexpr Code npos = ~Code{0};
+
+    static Code intern(const Symbol& sym) {
+        auto& st = storage();
+        {
+            std::shared_lock<std::shared_mutex> lock(st.mutex);
+            auto it = st.codes.find(sym);
+            if (it != st.codes.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(st.mutex);
+        auto it = st.codes.find(sym); // 加写锁前可能已被其它线程驻留
+        if (it != st.codes.end()) return it->second;
+        const auto code = static_cast<Code>(st.names.size());
+        st.names.push_back(sym);
+        try {
+            st.codes.emplace(st.names.back(), code);
+        } catch (...) {
+            st.names.pop_back();
+            throw;
+        }
+        return code;
+    }
+
+    /** 未驻留返回 npos（查询路径不插入） */
+    static Code find(const Symbol& sym) noexcept {
+        auto& st = storage();
+        std::shared_lock<std::shared_mutex> lock(st.mutex);
+        auto it = st.codes.find(sym);
+        return it == st.codes.end() ? npos : it->second;
+    }
+
+    /** 已驻留个数；编号为 [0, size()) */
+    static Code size() noexcept {
+        auto& st = storage();
+        std::shared_lock<std::shared_mutex> lock(st.mutex);
+        return static_cast<Code>(st.names.size());
+    }
+
+    static const Symbol& name(Code code) {
+        auto& st = storage();
+        std::shared_lock<std::shared_mutex> lock(st.mutex);
+        if (code >= st.names.size()) throw NotFoundException("symbol code not found");
+        return st.names[code];
+    }
+
+private:
+    struct Storage {
+        std::shared_mutex mutex;
+        std::unordered_map<Symbol, Code> codes;
+        std::deque<Symbol> names; // 下标即编号
+    };
+
+    static Storage& storage() {
+        static Storage st;
+        return st;
+    }
+};
+
+} // namespace trade_sim
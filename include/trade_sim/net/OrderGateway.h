@@ -0,0 +1,126 @@
+#pragma once
+
+#include "trade_sim/core/OrderEntryHandler.h"
+#include "trade_sim/io/BinaryProtocol.h"
+#include "trade_sim/net/Replication.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace trade_sim {
+
+/**
+ * 网关帧格式：u32 负载长度（本机字节序）+ 负载
+ * - 请求负载：WireMessage
+ * - 回报负载：WireReport
+ */
+using FrameLength = std::uint32_t;
+constexpr std::size_t kRequestFrameBytes = sizeof(FrameLength) + sizeof(WireMessage);
+constexpr std::size_t kReportFrameBytes = sizeof(FrameLength) + sizeof(WireReport);
+
+struct GatewayConfig {
+    std::string unixPath;     // 非空：监听 Unix domain socket
+    std::uint16_t tcpPort{0}; // unixPath 为空时监听 127.0.0.1:tcpPort（0 = 系统分配）
+    int auctionIntervalMs{0}; // > 0：集合竞价模式下定时出清
+    int replicationSyncMs{0}; // > 0：同步复制，本轮回写前最多等这么久备节点确认（见 OrderGateway）
+};
+
+/**
+ * OrderGateway：本机 socket 订单网关（Linux epoll，单线程事件循环）
+ * - 每个连接一个 Session：半帧暂存 + 待发回报队列；read 进所有连接共用的一块缓冲，空闲连接不占读缓冲
+ * - fd 用尽（EMFILE / ENFILE）时用预留 fd 接受并立即关闭新连接，避免监听 fd 持续可读导致空转
+ * - 一轮 epoll_wait 内先处理完所有可读连接，再按连接 writev 批量回写
+ * - Cancel / Amend 只接受本连接下、仍未结束的订单，否则就地回 Rejected（NotFound），不交给业务处理也不复制
+ * - Trade 回报路由给买卖双方订单所属的连接；出清时的结算拒单、Cancelled / Amended 路由给该订单所属连接
+ * - 订单归属在全部成交 / 撤单 / 结算拒单或连接关闭时回收，owners_ 只含未结束订单
+ * - TradeExecutor 非线程安全：所有业务处理都在 run() 所在线程完成
+ * - 挂接复制后：每条输入（含定时出清）处理前按序发布，本轮回写客户端前整批交给复制线程
+ * - 复制默认异步：客户端可能先收到 Accepted / Trade，备节点后收到输入；主节点此时被杀，
+ *   备节点接管后没有这些已确认的订单（丢失窗口 = 最近一两轮事件循环的输入）
+ * - replicationSyncMs > 0 时关闭该窗口：本轮回写前等待备节点确认本轮全部输入（每轮一次往返）；
+ *   超时或备节点失联则照常回写并计入 replicationSyncTimeouts（退化为异步，不停止服务）
+ */
+class OrderGateway {
+public:
+    OrderGateway(OrderEntryHandler& handler, GatewayConfig cfg);
+    ~OrderGateway();
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    /** 绑定并开始监听；返回 TCP 实际端口（Unix socket 返回 0） */
+    std::uint16_t listen();
+
+    /** 事件循环，直到 stop() */
+    void run();
+
+    /** 可跨线程 / 在信号处理函数中调用（eventfd 唤醒） */
+    void stop() noexcept;
+
+    std::size_t sessionCount() const noexcept { return sessions_.size(); }
+    /** 仍登记归属的订单数（未结束且所属连接未关闭） */
+    std::size_t trackedOrders() const noexcept { return owners_.size(); }
+    /** 定时出清中因资金 / 持仓不足被拒的订单数（Rejected 回报送往订单所属连接） */
+    std::uint64_t settlementRejects() const noexcept { return settlementRejects_; }
+    /** 同步复制模式下未等到备节点确认就回写的轮数 */
+    std::uint64_t replicationSyncTimeouts() const noexcept { return replicationSyncTimeouts_; }
+    /** fd 用尽时被接受后立即关闭的连接数 */
+    std::uint64_t droppedConnections() const noexcept { return droppedConnections_; }
+
+    /** 可选：挂接主备复制（不持有所有权，nullptr 解除；须在 run() 之前设置） */
+    void attachReplication(ReplicationPublisher* replication) noexcept { replication_ = replication; }
+
+private:
+    struct Session {
+        int fd{-1};
+        std::uint64_t id{0};
+        char partial[kRequestFrameBytes]{}; // 上次读到的不完整帧 [0, partialLen)
+        std::size_t partialLen{0};
+        std::vector<WireReport> out;   // 待发送回报
+        std::size_t sentBytes{0};      // out 对应帧流中已发送的字节数
+        bool dirty{false};             // 本轮有新回报
+        bool wantWrite{false};         // 已注册 EPOLLOUT
+        std::vector<OrderId> orders;   // 本连接下过的订单（含已结束的，惰性压缩）
+        std::size_t liveOrders{0};     // 其中仍登记在 owners_ 的个数
+    };
+
+    void acceptAll();
+    /** fd 用尽：释放预留 fd 接受一个连接并关闭，再补回预留；返回 false 表示无法腾出 fd */
+    bool dropOneConnection();
+    void onReadable(Session& s);
+    void flush(Session& s);
+    void close(std::uint64_t sessionId);
+    void route(Session* origin);
+    void deliver(std::uint64_t sessionId, const WireReport& r);
+    void adopt(Session& s, OrderId id);
+    void release(OrderId id);
+    void updateInterest(Session& s, bool wantWrite);
+    void markDirty(Session& s);
+    /** Cancel / Amend 的目标订单是否归本连接；其它消息恒为 true */
+    bool ownsTarget(const Session& s, const WireMessage& msg) const;
+
+    OrderEntryHandler& handler_;
+    GatewayConfig cfg_;
+    ReplicationPublisher* replication_{nullptr};
+    int listenFd_{-1};
+    int epollFd_{-1};
+    int wakeFd_{-1};
+    int reserveFd_{-1}; // 预留 fd（/dev/null），fd 用尽时腾给 accept
+    bool running_{false};
+    std::uint64_t nextSessionId_{1};
+    std::uint64_t settlementRejects_{0};
+    std::uint64_t replicationSyncTimeouts_{0};
+    std::uint64_t droppedConnections_{0};
+
+    std::unordered_map<std::uint64_t, std::unique_ptr<Session>> sessions_;
+    std::unordered_map<OrderId, std::uint64_t> owners_; // 未结束订单 orderId -> sessionId
+    std::vector<std::uint64_t> dirty_;                  // 本轮待 flush 的连接
+    std::vector<WireReport> scratch_;                   // handler 输出暂存
+    std::vector<char> readBuf_;                         // 所有连接共用的读缓冲：半帧 + 一次 read
+};
+
+} // namespace trade_sim
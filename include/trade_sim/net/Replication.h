@@ -0,0 +1,163 @@
+#pragma once
+
+#include "trade_sim/core/OrderEntryHandler.h"
+#include "trade_sim/io/BinaryProtocol.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace trade_sim {
+
+/**
+ * 主备复制（状态机复制）：主节点把已定序的输入原样发给备节点，
+ * 备节点按同一顺序交给同一套 OrderEntryHandler / TradeExecutor，状态与主节点逐条一致
+ * - 订单号、成交编号、撮合结果都由输入顺序决定，因此只需复制输入，不复制成交
+ * - 流格式：主 -> 备：ReplicationHello，随后 ReplicationRecord 流；备 -> 主：u64 已应用序号（累计确认）
+ * - 要求主备从相同初始状态开始（同为空，或加载同一份快照）
+ */
+enum class ReplicationKind : std::uint8_t { Message = 1, Uncross = 2 };
+
+constexpr char kReplicationMagic[8] = {'T', 'S', 'R', 'E', 'P', 'L', '\0', '\0'};
+constexpr std::uint32_t kReplicationVersion = 1;
+
+struct ReplicationHello {
+    char magic[8]{};
+    std::uint32_t version{0};
+    std::uint32_t recordSize{0};
+    std::uint64_t firstSeq{0}; // 随后第一条记录的序号
+};
+
+struct ReplicationRecord {
+    std::uint64_t seq{0};      // 从 1 开始连续
+    std::uint8_t kind{0};      // ReplicationKind
+    std::uint8_t reserved[7]{};
+    WireMessage msg;           // Message：原始输入；Uncross：空
+};
+
+static_assert(sizeof(ReplicationHello) == 24, "ReplicationHello must be 24 bytes");
+static_assert(sizeof(ReplicationRecord) == 80, "ReplicationRecord must be 80 bytes");
+static_assert(std::is_trivially_copyable<ReplicationRecord>::value, "ReplicationRecord must be trivially copyable");
+
+struct ReplicationConfig {
+    std::string unixPath;     // 非空：Unix domain socket
+    std::uint16_t tcpPort{0}; // unixPath 为空时使用 127.0.0.1:tcpPort
+    std::size_t maxPendingRecords{std::size_t{1} << 20}; // 主节点积压上限，超过即放弃备节点
+};
+
+/**
+ * ReplicationPublisher：主节点侧
+ * - publish 只把记录追加到本线程批次（一次 80 字节拷贝），不做系统调用
+ * - flush 把整批交给发送线程（每轮事件循环一次）；发送线程 send，确认线程收 ack，主节点默认不等待备节点
+ * - 因此默认是异步复制：已回报给客户端的输入可能尚未被备节点确认，主节点崩溃时备节点会缺少这部分；
+ *   需要零丢失时在回报前 waitAcked(publishedSeq())（OrderGateway 的 replicationSyncMs 即如此）
+ * - 备节点断开或积压超限后 healthy() 为 false，此后 publish 直接丢弃，主节点照常服务
+ * - publish / flush 只能在同一线程调用（与 TradeExecutor 同线程）
+ */
+class ReplicationPublisher {
+public:
+    explicit ReplicationPublisher(ReplicationConfig cfg);
+    ~ReplicationPublisher();
+
+    ReplicationPublisher(const ReplicationPublisher&) = delete;
+    ReplicationPublisher& operator=(const ReplicationPublisher&) = delete;
+
+    /** 连接备节点并发送 hello；失败抛 IOErrorException */
+    void connect();
+
+    void publish(const WireMessage& msg) { append(ReplicationKind::Message, &msg); }
+    void publishUncross() { append(ReplicationKind::Uncross, nullptr); }
+
+    void flush();
+
+    /** 等待备节点确认到 seq；超时或备节点断开返回 false */
+    bool waitAcked(std::uint64_t seq, int timeoutMs);
+
+    /** 发完已 flush 的记录后关闭写端并回收线程（备节点随之视为主节点退出） */
+    void close();
+
+    std::uint64_t publishedSeq() const noexcept { return seq_; }
+    std::uint64_t ackedSeq() const noexcept { return acked_.load(std::memory_order_acquire); }
+    bool healthy() const noexcept { return healthy_.load(std::memory_order_acquire); }
+
+private:
+    void append(ReplicationKind kind, const WireMessage* msg) {
+        ++seq_;
+        if (!healthy_.load(std::memory_order_relaxed)) return;
+        batch_.emplace_back();
+        ReplicationRecord& r = batch_.back();
+        r.seq = seq_;
+        r.kind = static_cast<std::uint8_t>(kind);
+        if (msg) r.msg = *msg;
+    }
+
+    void sendLoop();
+    void ackLoop();
+    void fail() noexcept;
+
+    ReplicationConfig cfg_;
+    int fd_{-1};
+    std::uint64_t seq_{0};
+    std::vector<ReplicationRecord> batch_; // 调用线程独占
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<ReplicationRecord> queued_; // 待发送（mutex_ 保护）
+    bool senderWaiting_{false};
+    bool closing_{false};
+
+    std::mutex ackMutex_;
+    std::condition_variable ackCv_;
+    std::atomic<std::uint64_t> acked_{0};
+    std::atomic<bool> healthy_{false};
+
+    std::thread sender_;
+    std::thread acker_;
+};
+
+/**
+ * ReplicationStandby：备节点侧
+ * - 接受一个主节点连接，按序应用记录（回报丢弃），每读完一批回一个累计确认
+ * - run 在主节点断开（进程被杀 / 关闭连接）时返回 true，此时可直接接管；stop() 时返回 false
+ * - 序号不连续或格式不符抛 ParseErrorException
+ */
+class ReplicationStandby {
+public:
+    ReplicationStandby(OrderEntryHandler& handler, ReplicationConfig cfg);
+    ~ReplicationStandby();
+
+    ReplicationStandby(const ReplicationStandby&) = delete;
+    ReplicationStandby& operator=(const ReplicationStandby&) = delete;
+
+    /** 绑定并开始监听；返回 TCP 实际端口（Unix socket 返回 0） */
+    std::uint16_t listen();
+
+    bool run();
+
+    /** 可跨线程 / 在信号处理函数中调用（eventfd 唤醒） */
+    void stop() noexcept;
+
+    std::uint64_t appliedSeq() const noexcept { return applied_.load(std::memory_order_acquire); }
+    /** 出清中因资金 / 持仓不足被拒的订单数（与主节点一致） */
+    std::uint64_t settlementRejects() const noexcept { return settlementRejects_; }
+
+private:
+    std::size_t apply(const char* data, std::size_t len);
+
+    OrderEntryHandler& handler_;
+    ReplicationConfig cfg_;
+    int listenFd_{-1};
+    int wakeFd_{-1};
+    bool haveHello_{false};
+    std::atomic<std::uint64_t> applied_{0};
+    std::uint64_t settlementRejects_{0};
+    std::vector<WireReport> scratch_;
+};
+
+} // namespace trade_sim
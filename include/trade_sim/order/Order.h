@@ -35,6 +35,15 @@ public:
     /** clone：演示多态拷贝（可选训练点） */
     virtual Order* cloneRaw() const = 0; // 返回 new 对象，调用方负责 delete
 
+    /** 改单（OrderManager::amend 使用）：就地修改，不重建对象 */
+    void amendQty(std::int64_t qty) {
+        if (qty <= 0) throw InvalidArgumentException("qty must be > 0");
+        qty_ = qty;
+    }
+
+    /** Market 只接受 0，Limit 要求 > 0 */
+    virtual void amendLimitPrice(Money limit) = 0;
+
 protected:
     OrderId id_{0};
     AccountId user_;
@@ -14,6 +14,9 @@ public:
     OrderKind kind() const noexcept override { return OrderKind::Market; }
     Money limitPrice() const override { return Money(0); }
     Order* cloneRaw() const override { return new MarketOrder(*this); }
+    void amendLimitPrice(Money limit) override {
+        if (limit.cents() != 0) throw InvalidArgumentException("market order has no limit price");
+    }
 };
 
 class LimitOrder final : public Order {
@@ -24,6 +27,10 @@ public:
     OrderKind kind() const noexcept override { return OrderKind::Limit; }
     Money limitPrice() const override { return limit_; }
     Order* cloneRaw() const override { return new LimitOrder(*this); }
+    void amendLimitPrice(Money limit) override {
+        if (limit.cents() <= 0) throw InvalidArgumentException("limit must be > 0");
+        limit_ = limit;
+    }
 
 private:
     Money limit_{0};
@@ -1,28 +1,150 @@
 #include "trade_sim/core/AccountManager.h"
+#include "trade_sim/io/Snapshot.h"
 #include "trade_sim/io/Storage.h"
 
+#include <functional>
+
 namespace trade_sim {
 
+namespace {
+
+std::uint32_t hashId(const AccountId& id) noexcept {
+    return static_cast<std::uint32_t>(std::hash<AccountId>{}(id));
+}
+
+} // namespace
+
 void AccountManager::createAccount(const AccountId& id, Money initial) {
     if (id.empty()) throw InvalidArgumentException("accountId is empty");
-    if (accounts_.find(id) != accounts_.end()) throw TradeSimException(ErrorCode::Duplicate, "account already exists");
-    accounts_.emplace(id, Account{id, initial});
+    if (find(id)) throw TradeSimException(ErrorCode::Duplicate, "account already exists");
+    if (accounts_.size() >= kEmpty - 1) throw TradeSimException(ErrorCode::InvalidState, "too many accounts");
+
+    // 先扩容索引再入表，失败时不留半插入状态
+    if ((accounts_.size() + 1) * 4 > slots_.size() * 3) grow();
+    accounts_.emplace_back(id, initial);
+    insertSlot(hashId(id), static_cast<std::uint32_t>(accounts_.size() - 1));
 }
 
 Account& AccountManager::getAccount(const AccountId& id) {
-    auto it = accounts_.find(id);
-    if (it == accounts_.end()) throw NotFoundException("account not found: " + id);
-    return it->second;
+    const Account* a = find(id);
+    if (!a) throw NotFoundException("account not found: " + id);
+    return const_cast<Account&>(*a);
 }
 
 const Account& AccountManager::getAccount(const AccountId& id) const {
-    auto it = accounts_.find(id);
-    if (it == accounts_.end()) throw NotFoundException("account not found: " + id);
-    return it->second;
+    const Account* a = find(id);
+    if (!a) throw NotFoundException("account not found: " + id);
+    return *a;
 }
 
 bool AccountManager::exists(const AccountId& id) const noexcept {
-    return accounts_.find(id) != accounts_.end();
+    return find(id) != nullptr;
+}
+
+const Account* AccountManager::find(const AccountId& id) const noexcept {
+    if (slots_.empty()) return nullptr;
+    const auto h = hashId(id);
+    const auto mask = slots_.size() - 1;
+    for (auto i = static_cast<std::size_t>(h) & mask;; i = (i + 1) & mask) {
+        const Slot& s = slots_[i];
+        if (s.index == kEmpty) return nullptr;
+        if (s.hash == h && accounts_[s.index].id() == id) return &accounts_[s.index];
+    }
+}
+
+void AccountManager::insertSlot(std::uint32_t hash, std::uint32_t index) noexcept {
+    const auto mask = slots_.size() - 1;
+    auto i = static_cast<std::size_t>(hash) & mask;
+    while (slots_[i].index != kEmpty) i = (i + 1) & mask;
+    slots_[i] = Slot{hash, index};
+}
+
+void AccountManager::grow() {
+    std::vector<Slot> old(slots_.empty() ? 16 : slots_.size() * 2);
+    old.swap(slots_);
+    for (const auto& s : old) {
+        if (s.index != kEmpty) insertSlot(s.hash, s.index);
+    }
+}
+
+void AccountManager::saveSnapshot(SnapshotWriter& w) const {
+    w.begin(SnapshotSection::Accounts, sizeof(SnapshotAccount));
+    std::uint32_t firstPosition = 0;
+    for (const auto& a : accounts_) {
+        SnapshotAccount r;
+        r.id = w.addString(a.id());
+        r.balance = a.balance().cents();
+        r.firstPosition = firstPosition;
+        r.positionCount = static_cast<std::uint32_t>(a.positionCount());
+        firstPosition += r.positionCount;
+        w.append(r);
+    }
+    w.end();
+
+    w.begin(SnapshotSection::Positions, sizeof(SnapshotPosition));
+    for (const auto& a : accounts_) {
+        a.forEachPositionCode([&w](SymbolTable::Code code, std::int64_t qty) {
+            SnapshotPosition p;
+            p.symbol = code; // Symbols 段即进程内驻留表，编号一致
+            p.qty = qty;
+            w.append(p);
+        });
+    }
+    w.end();
+
+    w.begin(SnapshotSection::AccountSlots, sizeof(SnapshotSlot));
+    for (const auto& s : slots_) w.append(SnapshotSlot{s.hash, s.index});
+    w.end();
+}
+
+void AccountManager::loadSnapshot(const SnapshotView& view) {
+    if (!accounts_.empty()) throw TradeSimException(ErrorCode::InvalidState, "snapshot restore requires empty AccountManager");
+    const auto recs = view.section<SnapshotAccount>(SnapshotSection::Accounts);
+    const auto positions = view.section<SnapshotPosition>(SnapshotSection::Positions);
+    const auto slots = view.section<SnapshotSlot>(SnapshotSection::AccountSlots);
+    if (recs.size >= kEmpty) throw ParseErrorException("snapshot has too many accounts");
+
+    std::deque<Account> accounts;
+    for (const auto& r : recs) {
+        if (r.firstPosition > positions.size || r.positionCount > positions.size - r.firstPosition) {
+            throw ParseErrorException("snapshot position range out of bounds");
+        }
+        accounts.emplace_back(AccountId(view.string(r.id)), Money(r.balance));
+        Account& a = accounts.back();
+        for (std::uint32_t i = 0; i < r.positionCount; ++i) {
+            const auto& p = positions[r.firstPosition + i];
+            a.restorePosition(view.symbol(p.symbol), p.qty);
+        }
+    }
+
+    // 索引：探针一致且容量合法时整段拷贝（下标仍逐个校验），否则重建
+    std::vector<Slot> table;
+    const auto cap = slots.size;
+    const bool reusable = view.hashCompatible() && cap >= 16 && (cap & (cap - 1)) == 0 &&
+                          accounts.size() * 4 <= cap * 3;
+    if (reusable) {
+        table.reserve(cap);
+        std::size_t used = 0;
+        for (const auto& s : slots) {
+            if (s.index != kEmpty) {
+                if (s.index >= accounts.size()) throw ParseErrorException("snapshot account slot out of range");
+                ++used;
+            }
+            table.push_back(Slot{s.hash, s.index});
+        }
+        if (used != accounts.size()) throw ParseErrorException("snapshot account index mismatch");
+    }
+
+    accounts_.swap(accounts);
+    if (reusable) {
+        slots_.swap(table);
+        return;
+    }
+    slots_.clear();
+    while (slots_.size() < 16 || accounts_.size() * 4 > slots_.size() * 3) {
+        slots_.assign(slots_.empty() ? 16 : slots_.size() * 2, Slot{});
+    }
+    for (std::uint32_t i = 0; i < accounts_.size(); ++i) insertSlot(hashId(accounts_[i].id()), i);
 }
 
 void AccountManager::loadFromFile(const std::string& path) {
@@ -0,0 +1,226 @@
+#include "trade_sim/core/FlightRecorder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <new>
+
+namespace trade_sim {
+
+namespace {
+
+constexpr char kMagic[8] = {'T', 'S', 'F', 'L', 'I', 'G', 'H', 'T'};
+
+std::uint64_t steadyNanos() noexcept {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+// 时钟标定起点（静态初始化时取）
+const std::uint64_t g_startTicks = FlightRecorder::now();
+const std::uint64_t g_startNanos = steadyNanos();
+
+// 环注册表：只追加，环发布后不再释放（线程退出后记录仍可转储）
+std::atomic<std::size_t> g_ringCount{0};
+std::atomic<void*> g_rings[FlightRecorder::kMaxRings];
+
+// 终止处理：转储路径 + 原 handler
+std::mutex g_terminateMutex;
+std::string g_terminatePath;
+std::terminate_handler g_prevTerminate = nullptr;
+bool g_terminateInstalled = false;
+
+void onTerminate() {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(g_terminateMutex);
+        path = g_terminatePath;
+    }
+    FlightRecorder::dumpNoThrow(path);
+    if (g_prevTerminate) g_prevTerminate();
+    std::abort();
+}
+
+template <class T>
+void writeRaw(std::FILE* f, const T* p, std::size_t n, const std::string& path) {
+    if (n && std::fwrite(p, sizeof(T), n, f) != n) {
+        std::fclose(f);
+        throw IOErrorException("write flight dump failed: " + path);
+    }
+}
+
+template <class T>
+void readRaw(std::ifstream& in, T* p, std::size_t n, const std::string& path) {
+    in.read(reinterpret_cast<char*>(p), static_cast<std::streamsize>(sizeof(T) * n));
+    if (!in) throw ParseErrorException("truncated flight dump: " + path);
+}
+
+} // namespace
+
+FlightRecorder::Ring* FlightRecorder::attachThread() noexcept {
+    // 线程退出时归还环；析构后本线程若再记录会重新领取
+    struct ReleaseOnExit {
+        Ring* ring{nullptr};
+        ~ReleaseOnExit() {
+            if (!ring) return;
+            tRing_ = nullptr;
+            ring->inUse.store(false, std::memory_order_release);
+        }
+    };
+    thread_local ReleaseOnExit release;
+
+    Ring* ring = nullptr;
+    const auto count = std::min(g_ringCount.load(std::memory_order_acquire), kMaxRings);
+    for (std::size_t i = 0; i < count && !ring; ++i) {
+        auto* r = static_cast<Ring*>(g_rings[i].load(std::memory_order_acquire));
+        bool expected = false;
+        if (r && r->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) ring = r;
+    }
+
+    if (!ring) {
+        const auto idx = g_ringCount.fetch_add(1, std::memory_order_acq_rel);
+        if (idx >= kMaxRings) return nullptr;
+        ring = new (std::nothrow) Ring;
+        if (!ring) return nullptr;
+        ring->thread = static_cast<std::uint32_t>(idx);
+        ring->inUse.store(true, std::memory_order_relaxed);
+        g_rings[idx].store(ring, std::memory_order_release);
+    }
+
+    release.ring = ring;
+    tRing_ = ring;
+    return ring;
+}
+
+namespace {
+
+/** 拷贝一个环的有效记录；与写者并发时丢弃拷贝期间被覆盖的部分 */
+template <class Ring>
+std::uint64_t copyRing(const Ring& ring, std::size_t capacity, std::vector<FlightRecord>& out) {
+    const auto head = ring.head.load(std::memory_order_acquire);
+    const auto n = std::min<std::uint64_t>(head, capacity);
+    const auto begin = out.size();
+    for (auto seq = head - n; seq < head; ++seq) out.push_back(ring.records[seq & (capacity - 1)].load());
+
+    // 写者可能正在写 headAfter 号记录（覆盖 headAfter - capacity 号），保守多丢一条
+    // fence 保证上面读到的任何被覆盖的字，其写入序号都反映在 headAfter 中（与 write 中的 release fence 配对）；
+    // 记录内各字可能来自不同次写入，被覆盖过的记录整条丢弃
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const auto headAfter = ring.head.load(std::memory_order_acquire);
+    const auto oldestIntact = headAfter + 1 > capacity ? headAfter + 1 - capacity : 0;
+    auto keep = begin;
+    for (auto i = begin; i < out.size(); ++i) {
+        const auto expected = head - n + (i - begin);
+        if (out[i].seq == expected && expected >= oldestIntact) out[keep++] = out[i];
+    }
+    out.resize(keep);
+    return head;
+}
+
+} // namespace
+
+std::vector<FlightRecord> FlightRecorder::snapshot() {
+    std::vector<FlightRecord> out;
+    const auto count = std::min(g_ringCount.load(std::memory_order_acquire), kMaxRings);
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto* r = static_cast<const Ring*>(g_rings[i].load(std::memory_order_acquire));
+        if (r) copyRing(*r, kCapacity, out);
+    }
+    return out;
+}
+
+std::size_t FlightRecorder::dump(const std::string& path) {
+    FlightDumpHeader h;
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.recordSize = sizeof(FlightRecord);
+    h.startTicks = g_startTicks;
+    h.startNanos = g_startNanos;
+
+    std::vector<FlightRingHeader> rings;
+    std::vector<FlightRecord> records;
+    const auto count = std::min(g_ringCount.load(std::memory_order_acquire), kMaxRings);
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto* r = static_cast<const Ring*>(g_rings[i].load(std::memory_order_acquire));
+        if (!r) continue;
+        const auto before = records.size();
+        FlightRingHeader rh;
+        rh.thread = r->thread;
+        rh.head = copyRing(*r, kCapacity, records);
+        rh.count = records.size() - before;
+        rings.push_back(rh);
+    }
+    h.ringCount = static_cast<std::uint32_t>(rings.size());
+    h.dumpTicks = now();
+    h.dumpNanos = steadyNanos();
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) throw IOErrorException("cannot open file: " + path);
+    writeRaw(f, &h, 1, path);
+    std::size_t off = 0;
+    for (const auto& rh : rings) {
+        writeRaw(f, &rh, 1, path);
+        writeRaw(f, records.data() + off, rh.count, path);
+        off += rh.count;
+    }
+    if (std::fclose(f) != 0) throw IOErrorException("close flight dump failed: " + path);
+    return records.size();
+}
+
+void FlightRecorder::dumpNoThrow(const std::string& path) noexcept {
+    if (path.empty()) return;
+    try {
+        const auto n = dump(path);
+        std::fprintf(stderr, "flight recorder: %zu records dumped to %s\n", n, path.c_str());
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "flight recorder dump failed: %s\n", e.what());
+    } catch (...) {
+        std::fprintf(stderr, "flight recorder dump failed\n");
+    }
+}
+
+void FlightRecorder::installTerminateHandler(const std::string& path) {
+    std::lock_guard<std::mutex> lock(g_terminateMutex);
+    g_terminatePath = path;
+    if (!g_terminateInstalled) {
+        g_prevTerminate = std::set_terminate(onTerminate);
+        g_terminateInstalled = true;
+    }
+}
+
+FlightDump FlightRecorder::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw IOErrorException("cannot open file: " + path);
+
+    FlightDump d;
+    readRaw(in, &d.header, 1, path);
+    if (std::memcmp(d.header.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw ParseErrorException("not a flight dump: " + path);
+    }
+    if (d.header.version != kVersion || d.header.recordSize != sizeof(FlightRecord)) {
+        throw ParseErrorException("unsupported flight dump version: " + path);
+    }
+    for (std::uint32_t i = 0; i < d.header.ringCount; ++i) {
+        FlightRingHeader rh;
+        readRaw(in, &rh, 1, path);
+        if (rh.count > kCapacity) throw ParseErrorException("corrupt flight dump ring: " + path);
+        const auto off = d.records.size();
+        d.records.resize(off + rh.count);
+        readRaw(in, d.records.data() + off, rh.count, path);
+    }
+    return d;
+}
+
+double FlightDump::nanosBeforeDump(std::uint64_t ticks) const noexcept {
+    const auto spanTicks = static_cast<double>(header.dumpTicks - header.startTicks);
+    const auto spanNanos = static_cast<double>(header.dumpNanos - header.startNanos);
+    const double ticksPerNano = spanTicks > 0 && spanNanos > 0 ? spanTicks / spanNanos : 1.0;
+    return (static_cast<double>(ticks) - static_cast<double>(header.dumpTicks)) / ticksPerNano;
+}
+
+} // namespace trade_sim
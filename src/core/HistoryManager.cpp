@@ -1,7 +1,44 @@
 #include "trade_sim/core/HistoryManager.h"
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+
 namespace trade_sim {
 
+namespace {
+
+/** 开放寻址表容量：2 的幂，装载率 ≤ 0.75 */
+std::size_t slotCapacity(std::size_t n) noexcept {
+    std::size_t cap = 16;
+    while (n * 4 > cap * 3) cap *= 2;
+    return cap;
+}
+
+void insertSlot(std::vector<SnapshotSlot>& slots, std::uint32_t hash, std::uint32_t index) noexcept {
+    const auto mask = slots.size() - 1;
+    auto i = static_cast<std::size_t>(hash) & mask;
+    while (slots[i].index != ~std::uint32_t{0}) i = (i + 1) & mask;
+    slots[i] = SnapshotSlot{hash, index};
+}
+
+} // namespace
+
+HistoryManager::HistoryManager(HistoryManager&& other) noexcept { *this = std::move(other); }
+
+HistoryManager& HistoryManager::operator=(HistoryManager&& other) noexcept {
+    if (this == &other) return *this;
+    const bool rebuilt = !other.rebuiltSlots_.empty() && other.baseSlots_.data == other.rebuiltSlots_.data();
+    trades_ = std::move(other.trades_);
+    index_ = std::move(other.index_);
+    base_ = std::move(other.base_);
+    rebuiltSlots_ = std::move(other.rebuiltSlots_);
+    baseSlots_ = rebuilt ? SnapshotArray<SnapshotSlot>{rebuiltSlots_.data(), rebuiltSlots_.size()} : other.baseSlots_;
+    other.baseSlots_ = {};
+    other.rebuiltSlots_.clear();
+    return *this;
+}
+
 void HistoryManager::record(const Trade& t, const AccountId& buyer, const AccountId& seller) {
     trades_[t.tradeId] = t;
     index_[buyer].push_back(t.tradeId);
@@ -10,10 +47,28 @@ void HistoryManager::record(const Trade& t, const AccountId& buyer, const Accoun
 
 std::vector<Trade> HistoryManager::historyOf(const AccountId& user) const {
     std::vector<Trade> out;
+
+    const auto u = baseUser(user);
+    if (u != kNoUser) {
+        const auto offsets = base_->section<std::uint64_t>(SnapshotSection::HistoryOffsets);
+        const auto entries = base_->section<std::uint32_t>(SnapshotSection::HistoryEntries);
+        const auto trades = base_->section<SnapshotTrade>(SnapshotSection::Trades);
+        const auto b = offsets[u], e = offsets[u + 1];
+        if (b > e || e > entries.size) throw ParseErrorException("snapshot history range out of bounds");
+        out.reserve(static_cast<std::size_t>(e - b));
+        for (auto i = b; i < e; ++i) {
+            const auto pos = entries[static_cast<std::size_t>(i)];
+            if (pos >= trades.size) throw ParseErrorException("snapshot trade index out of bounds");
+            const auto& r = trades[pos];
+            out.push_back(Trade{r.tradeId, r.buyOrderId, r.sellOrderId, SymbolTable::name(base_->symbol(r.symbol)),
+                                r.qty, Money(r.price)});
+        }
+    }
+
     auto it = index_.find(user);
     if (it == index_.end()) return out;
 
-    out.reserve(it->second.size());
+    out.reserve(out.size() + it->second.size());
     for (auto tid : it->second) {
         auto jt = trades_.find(tid);
         if (jt != trades_.end()) out.push_back(jt->second);
@@ -21,6 +76,160 @@ std::vector<Trade> HistoryManager::historyOf(const AccountId& user) const {
     return out;
 }
 
+std::size_t HistoryManager::tradeCount() const noexcept {
+    const auto base = base_ ? base_->section<SnapshotTrade>(SnapshotSection::Trades).size : 0;
+    return base + trades_.size();
+}
+
+std::uint32_t HistoryManager::baseUser(const AccountId& user) const {
+    if (!base_ || baseSlots_.size == 0) return kNoUser;
+    const auto users = base_->section<SnapshotString>(SnapshotSection::HistoryUsers);
+    const auto h = snapshotHash(user);
+    const auto mask = baseSlots_.size - 1;
+    for (auto i = static_cast<std::size_t>(h) & mask, probes = std::size_t{0}; probes < baseSlots_.size;
+         i = (i + 1) & mask, ++probes) {
+        const auto& s = baseSlots_[i];
+        if (s.index == kNoUser) return kNoUser;
+        if (s.index >= users.size) throw ParseErrorException("snapshot history slot out of range");
+        if (s.hash == h && base_->string(users[s.index]) == user) return s.index;
+    }
+    return kNoUser;
+}
+
+void HistoryManager::saveSnapshot(SnapshotWriter& w) const {
+    const SnapshotArray<SnapshotTrade> baseTrades =
+        base_ ? base_->section<SnapshotTrade>(SnapshotSection::Trades) : SnapshotArray<SnapshotTrade>{};
+    const SnapshotArray<SnapshotString> baseUsers =
+        base_ ? base_->section<SnapshotString>(SnapshotSection::HistoryUsers) : SnapshotArray<SnapshotString>{};
+
+    // 内存里的成交按编号排序后接在快照成交之后
+    std::vector<const Trade*> delta;
+    delta.reserve(trades_.size());
+    for (const auto& kv : trades_) delta.push_back(&kv.second);
+    std::sort(delta.begin(), delta.end(), [](const Trade* a, const Trade* b) { return a->tradeId < b->tradeId; });
+    if (baseTrades.size + delta.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw TradeSimException(ErrorCode::InvalidState, "snapshot supports at most 2^32 - 1 trades");
+    }
+    // tradeId -> 写出位置：编号连续时直接相减，否则在连续数组上二分（不追指针）
+    std::vector<TradeId> ids(delta.size());
+    for (std::size_t i = 0; i < delta.size(); ++i) ids[i] = delta[i]->tradeId;
+    const bool dense = !ids.empty() && ids.back() - ids.front() + 1 == ids.size();
+    auto positionOf = [&](TradeId id) {
+        const auto rank = dense ? static_cast<std::size_t>(id - ids.front())
+                                : static_cast<std::size_t>(std::lower_bound(ids.begin(), ids.end(), id) - ids.begin());
+        return static_cast<std::uint32_t>(baseTrades.size + rank);
+    };
+
+    w.begin(SnapshotSection::Trades, sizeof(SnapshotTrade));
+    bool identity = true;
+    for (std::uint32_t c = 0; base_ && c < base_->section<SnapshotString>(SnapshotSection::Symbols).size; ++c) {
+        identity = identity && base_->symbol(c) == c;
+    }
+    if (identity) {
+        w.append(baseTrades.data, baseTrades.size * sizeof(SnapshotTrade));
+    } else {
+        for (auto r : baseTrades) {
+            r.symbol = base_->symbol(r.symbol);
+            w.append(r);
+        }
+    }
+    for (const Trade* t : delta) {
+        SnapshotTrade r;
+        r.tradeId = t->tradeId;
+        r.buyOrderId = t->buyOrderId;
+        r.sellOrderId = t->sellOrderId;
+        r.qty = t->qty;
+        r.price = t->price.cents();
+        r.symbol = SymbolTable::intern(t->symbol);
+        w.append(r);
+    }
+    w.end();
+
+    // 用户：快照内用户保持原下标，新用户接在后面
+    std::vector<std::pair<std::uint32_t, const std::vector<TradeId>*>> deltaOf;
+    std::vector<const AccountId*> newUsers;
+    deltaOf.reserve(index_.size());
+    for (const auto& kv : index_) {
+        auto u = baseUser(kv.first);
+        if (u == kNoUser) {
+            u = static_cast<std::uint32_t>(baseUsers.size + newUsers.size());
+            newUsers.push_back(&kv.first);
+        }
+        deltaOf.emplace_back(u, &kv.second);
+    }
+    std::sort(deltaOf.begin(), deltaOf.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    const auto userCount = baseUsers.size + newUsers.size();
+    if (userCount >= kNoUser) throw TradeSimException(ErrorCode::InvalidState, "too many history users");
+
+    std::vector<SnapshotSlot> slots(userCount ? slotCapacity(userCount) : 0);
+    w.begin(SnapshotSection::HistoryUsers, sizeof(SnapshotString));
+    for (std::size_t u = 0; u < userCount; ++u) {
+        const std::string_view name = u < baseUsers.size ? base_->string(baseUsers[u]) : *newUsers[u - baseUsers.size];
+        w.append(w.addString(name));
+        insertSlot(slots, snapshotHash(name), static_cast<std::uint32_t>(u));
+    }
+    w.end();
+    w.writeSection(SnapshotSection::HistoryUserSlots, slots.data(), slots.size());
+
+    const auto baseOffsets = base_ ? base_->section<std::uint64_t>(SnapshotSection::HistoryOffsets)
+                                   : SnapshotArray<std::uint64_t>{};
+    const auto baseEntries = base_ ? base_->section<std::uint32_t>(SnapshotSection::HistoryEntries)
+                                   : SnapshotArray<std::uint32_t>{};
+    auto baseRange = [&](std::size_t u) {
+        if (u >= baseUsers.size) return std::make_pair(std::uint64_t{0}, std::uint64_t{0});
+        const auto b = baseOffsets[u], e = baseOffsets[u + 1];
+        if (b > e || e > baseEntries.size) throw ParseErrorException("snapshot history range out of bounds");
+        return std::make_pair(b, e);
+    };
+
+    if (userCount) {
+        w.begin(SnapshotSection::HistoryOffsets, sizeof(std::uint64_t));
+        std::uint64_t off = 0;
+        auto d = deltaOf.begin();
+        for (std::size_t u = 0; u < userCount; ++u) {
+            w.append(off);
+            const auto r = baseRange(u);
+            off += r.second - r.first;
+            if (d != deltaOf.end() && d->first == u) off += (d++)->second->size();
+        }
+        w.append(off);
+        w.end();
+    }
+
+    w.begin(SnapshotSection::HistoryEntries, sizeof(std::uint32_t));
+    auto d = deltaOf.begin();
+    for (std::size_t u = 0; u < userCount; ++u) {
+        const auto r = baseRange(u);
+        w.append(baseEntries.data + r.first, static_cast<std::size_t>(r.second - r.first) * sizeof(std::uint32_t));
+        if (d != deltaOf.end() && d->first == u) {
+            for (auto tid : *(d++)->second) w.append(positionOf(tid));
+        }
+    }
+    w.end();
+}
+
+void HistoryManager::loadSnapshot(std::shared_ptr<const SnapshotView> view) {
+    if (!view) throw InvalidArgumentException("loadSnapshot: null view");
+    if (tradeCount() != 0 || !index_.empty()) {
+        throw TradeSimException(ErrorCode::InvalidState, "snapshot restore requires empty HistoryManager");
+    }
+
+    const auto users = view->section<SnapshotString>(SnapshotSection::HistoryUsers);
+    const auto slots = view->section<SnapshotSlot>(SnapshotSection::HistoryUserSlots);
+    const auto cap = slots.size;
+    const bool reusable = view->hashCompatible() && cap >= 16 && (cap & (cap - 1)) == 0 && users.size * 4 <= cap * 3;
+
+    std::vector<SnapshotSlot> rebuilt;
+    if (!reusable && users.size) {
+        rebuilt.resize(slotCapacity(users.size));
+        for (std::uint32_t u = 0; u < users.size; ++u) insertSlot(rebuilt, snapshotHash(view->string(users[u])), u);
+    }
+
+    base_ = std::move(view);
+    rebuiltSlots_.swap(rebuilt);
+    baseSlots_ = reusable ? slots : SnapshotArray<SnapshotSlot>{rebuiltSlots_.data(), rebuiltSlots_.size()};
+}
+
 void HistoryManager::loadFromFile(const std::string& path) {
     // TODO: read trades.csv and rebuild index_ (path is a directory, fixed filename)
     (void)path;
@@ -1,6 +1,10 @@
 #include "trade_sim/common/Exceptions.h"
 #include "trade_sim/core/MatchingEngine.h"
 
+#include <algorithm>
+#include <iterator>
+#include <new>
+
 namespace trade_sim {
 
 std::vector<Trade> MatchingEngine::match(const Order& incoming) {
@@ -14,7 +18,417 @@ std::vector<Trade> MatchingEngine::match(const Order& incoming) {
     if(incoming.symbol().empty()){
         throw InvalidArgumentException("incoming.symbol is empty");
     }
+    if (mode_ != MatchingMode::Auction) return {};
+
+    // 集合竞价：只入簿，不成交
+    rest(incoming, incoming.qty());
     return {};
 }
 
+void MatchingEngine::restoreResting(const Order& order, std::int64_t remaining) {
+    if (mode_ != MatchingMode::Auction) {
+        throw TradeSimException(ErrorCode::InvalidState, "resting orders require auction mode");
+    }
+    if (remaining <= 0 || remaining > order.qty()) {
+        throw InvalidArgumentException("restore remaining qty out of range");
+    }
+    if (order.symbol().empty()) throw InvalidArgumentException("order symbol is empty");
+    rest(order, remaining);
+}
+
+void MatchingEngine::restoreNextTradeId(TradeId next) {
+    if (next == 0) throw InvalidArgumentException("next trade id must be > 0");
+    nextTradeId_ = next;
+}
+
+void MatchingEngine::rest(const Order& order, std::int64_t qty) {
+    if (resting(order.id(), nullptr)) {
+        throw TradeSimException(ErrorCode::Duplicate, "order already resting in auction book");
+    }
+    auto& book = auctions_[order.symbol()];
+    const bool market = order.kind() == OrderKind::Market;
+    Location& slot = locationSlot(order.id());
+    try {
+        slot = enqueue(book, order.id(), qty, market ? 0 : order.limitPrice().cents(), order.side() == Side::Buy,
+                       market);
+    } catch (...) {
+        clearLocation(order.id());
+        throw;
+    }
+    ++book.orderCount;
+    ++restingCount_;
+}
+
+std::vector<Trade> MatchingEngine::uncross(const Symbol& sym, const FillHandler& settle) {
+    if (mode_ != MatchingMode::Auction) {
+        throw TradeSimException(ErrorCode::InvalidState, "uncross requires auction mode");
+    }
+    auto it = auctions_.find(sym);
+    if (it == auctions_.end()) return {};
+    auto trades = uncrossBook(it->first, it->second, settle);
+    maybeRebuildIndex();
+    return trades;
+}
+
+std::vector<Trade> MatchingEngine::uncrossAll(const FillHandler& settle) {
+    if (mode_ != MatchingMode::Auction) {
+        throw TradeSimException(ErrorCode::InvalidState, "uncross requires auction mode");
+    }
+    std::vector<Trade> out;
+    for (auto& kv : auctions_) {
+        auto trades = uncrossBook(kv.first, kv.second, settle);
+        out.insert(out.end(), std::make_move_iterator(trades.begin()), std::make_move_iterator(trades.end()));
+    }
+    maybeRebuildIndex();
+    return out;
+}
+
+void MatchingEngine::cancel(const Order& order) {
+    if (mode_ != MatchingMode::Auction) return;
+    Location* loc = nullptr;
+    AuctionEntry* e = resting(order.id(), &loc);
+    if (!e) return; // 已全部成交或已撤
+
+    AuctionQueue& q = loc->buy ? loc->level->buys : loc->level->sells;
+    (loc->buy ? loc->level->buyQty : loc->level->sellQty) -= e->qty;
+    e->qty = 0;
+    --q.live;
+    ++tombstones_;
+    --auctions_.find(order.symbol())->second.orderCount;
+    --restingCount_;
+    clearLocation(order.id());
+    maybeRebuildIndex();
+}
+
+bool MatchingEngine::amend(const Order& order, std::int64_t newQty, Money newLimit) {
+    if (newQty <= 0) throw InvalidArgumentException("amend qty must be > 0");
+    if (order.kind() == OrderKind::Market ? newLimit.cents() != 0 : newLimit.cents() <= 0) {
+        throw InvalidArgumentException("amend limit price invalid for order kind");
+    }
+    if (mode_ != MatchingMode::Auction) return true;
+
+    Location* loc = nullptr;
+    AuctionEntry* e = resting(order.id(), &loc);
+    if (!e) throw TradeSimException(ErrorCode::InvalidState, "order not resting in auction book");
+
+    const auto filled = order.qty() - e->qty;
+    const auto newLeaves = newQty - filled;
+    if (newLeaves <= 0) throw InvalidArgumentException("amend qty must exceed filled qty");
+
+    const auto newPrice = loc->market ? 0 : newLimit.cents();
+    if (newPrice == loc->level->price && newLeaves <= e->qty) {
+        // 就地减量：队列位置不变
+        (loc->buy ? loc->level->buyQty : loc->level->sellQty) -= e->qty - newLeaves;
+        e->qty = newLeaves;
+        return true;
+    }
+
+    // 改价 / 加量：先挂到新位置（失败则簿不变），再把原位置置为墓碑
+    AuctionQueue& oldQ = loc->buy ? loc->level->buys : loc->level->sells;
+    const auto oldPos = static_cast<std::size_t>(loc->seq - oldQ.base);
+    AuctionLevel* oldLevel = loc->level;
+    const auto moved = enqueue(auctions_.find(order.symbol())->second, order.id(), newLeaves, newPrice, loc->buy, loc->market);
+
+    AuctionEntry& old = oldQ.entries[oldPos]; // enqueue 可能令同一队列扩容，重新取址
+    (loc->buy ? oldLevel->buyQty : oldLevel->sellQty) -= old.qty;
+    old.qty = 0;
+    --oldQ.live;
+    ++tombstones_;
+    *loc = moved;
+    maybeRebuildIndex();
+    return false;
+}
+
+std::size_t MatchingEngine::pendingCount(const Symbol& sym) const noexcept {
+    auto it = auctions_.find(sym);
+    return it == auctions_.end() ? 0 : it->second.orderCount;
+}
+
+MatchingEngine::AuctionEntry* MatchingEngine::resting(OrderId id, Location** loc) {
+    Location* found = findLocation(id);
+    if (!found) return nullptr;
+
+    Location& l = *found;
+    AuctionQueue& q = l.buy ? l.level->buys : l.level->sells;
+    if (l.seq < q.base + q.head || l.seq - q.base >= q.entries.size()) return nullptr;
+    AuctionEntry& e = q.entries[static_cast<std::size_t>(l.seq - q.base)];
+    if (e.id != id || e.qty == 0) return nullptr;
+
+    if (loc) *loc = &l;
+    return &e;
+}
+
+MatchingEngine::Location* MatchingEngine::findLocation(OrderId id) noexcept {
+    if (id >= slotBase_ && id - slotBase_ < slots_.size()) {
+        Location& l = slots_[static_cast<std::size_t>(id - slotBase_)];
+        if (l.level && l.epoch == epoch_) return &l;
+    }
+    if (sparse_.empty()) return nullptr;
+    auto it = sparse_.find(id);
+    return it == sparse_.end() || it->second.epoch != epoch_ ? nullptr : &it->second;
+}
+
+MatchingEngine::Location& MatchingEngine::locationSlot(OrderId id) {
+    if (slots_.empty()) slotBase_ = id;
+    if (id >= slotBase_) {
+        const auto off = id - slotBase_;
+        if (off < slots_.size()) return slots_[static_cast<std::size_t>(off)];
+        if (off < slots_.size() + kDenseSlack) {
+            slots_.resize(static_cast<std::size_t>(off) + 1);
+            return slots_.back();
+        }
+    } else if (slotBase_ - id <= kDenseSlack) {
+        // 向前扩展（快照按队列顺序恢复时 id 可能递减）：按窗口大小倍增，均摊 O(1)
+        const auto grow = std::min<OrderId>(slotBase_, std::max<OrderId>(slotBase_ - id, slots_.size()));
+        slots_.insert(slots_.begin(), static_cast<std::size_t>(grow), Location{});
+        slotBase_ -= grow;
+        return slots_[static_cast<std::size_t>(id - slotBase_)];
+    }
+    return sparse_[id];
+}
+
+void MatchingEngine::clearLocation(OrderId id) noexcept {
+    if (id >= slotBase_ && id - slotBase_ < slots_.size()) slots_[static_cast<std::size_t>(id - slotBase_)].level = nullptr;
+    if (!sparse_.empty()) sparse_.erase(id);
+}
+
+MatchingEngine::Location MatchingEngine::enqueue(AuctionBook& book, OrderId id, std::int64_t qty, long long price, bool buy, bool market) {
+    AuctionLevel& level = market ? book.market : book.levels[price];
+    level.price = price;
+    AuctionQueue& q = buy ? level.buys : level.sells;
+    q.entries.push_back({id, qty});
+    (buy ? level.buyQty : level.sellQty) += qty;
+    ++q.live;
+
+    Location loc;
+    loc.level = &level;
+    loc.seq = q.base + q.entries.size() - 1;
+    loc.buy = buy;
+    loc.market = market;
+    loc.epoch = epoch_;
+    return loc;
+}
+
+void MatchingEngine::compactHead(AuctionQueue& q) {
+    while (q.head < q.entries.size() && q.entries[q.head].qty == 0) ++q.head;
+    if (q.head == q.entries.size() || (q.head > 64 && q.head * 2 > q.entries.size())) {
+        q.entries.erase(q.entries.begin(), q.entries.begin() + static_cast<std::ptrdiff_t>(q.head));
+        q.base += q.head;
+        q.head = 0;
+    }
+}
+
+void MatchingEngine::maybeRebuildIndex() {
+    if (tombstones_ + retired_ <= restingCount_ + 1024) return;
+
+    // 稠密窗口只保留最近 kDenseSlack 个编号：更早仍在簿的订单（长期挂单）移入 sparse_，
+    // 否则一张老订单会让窗口随此后发出的每个编号无限增长
+    const OrderId windowEnd = slotBase_ + slots_.size();
+    const OrderId cutoff = windowEnd - slotBase_ > kDenseSlack ? windowEnd - kDenseSlack : slotBase_;
+    auto keepDense = [&](OrderId id, const Location* loc) {
+        return id >= cutoff && id < windowEnd && loc == &slots_[static_cast<std::size_t>(id - slotBase_)];
+    };
+
+    // 阶段 1：只分配不修改（失败则放弃本次重建，下次再试）；不留在稠密窗口的位置写入新的 sparse
+    std::vector<AuctionQueue*> queues;
+    std::vector<std::vector<AuctionEntry>> compacted;
+    std::unordered_map<OrderId, Location> freshSparse;
+    try {
+        auto collect = [&](AuctionLevel& level) {
+            for (AuctionQueue* q : {&level.buys, &level.sells}) {
+                std::vector<AuctionEntry> live;
+                live.reserve(q->live);
+                for (std::size_t i = q->head; i < q->entries.size(); ++i) {
+                    if (q->entries[i].qty == 0) continue;
+                    const OrderId id = q->entries[i].id;
+                    const Location* loc = findLocation(id);
+                    if (!keepDense(id, loc)) {
+                        Location moved = *loc;
+                        moved.seq = q->base + q->entries.size() + live.size(); // 重建后的新序号
+                        moved.epoch = epoch_ + 1;
+                        freshSparse.emplace(id, moved);
+                    }
+                    live.push_back(q->entries[i]);
+                }
+                queues.push_back(q);
+                compacted.push_back(std::move(live));
+            }
+        };
+        for (auto& kv : auctions_) {
+            collect(kv.second.market);
+            for (auto& lv : kv.second.levels) collect(lv.second);
+        }
+    } catch (const std::bad_alloc&) {
+        return;
+    }
+
+    // 阶段 2：提交（不抛异常）：换入压缩后的队列，就地改写留在稠密窗口的位置序号与 epoch
+    OrderId minDense = windowEnd;
+    for (std::size_t i = 0; i < queues.size(); ++i) {
+        AuctionQueue& q = *queues[i];
+        q.base += q.entries.size();
+        q.entries.swap(compacted[i]);
+        q.head = 0;
+        for (std::size_t j = 0; j < q.entries.size(); ++j) {
+            const OrderId id = q.entries[j].id;
+            Location* loc = findLocation(id);
+            if (!keepDense(id, loc)) continue;
+            loc->seq = q.base + j;
+            loc->epoch = epoch_ + 1;
+            if (id < minDense) minDense = id;
+        }
+    }
+    sparse_.swap(freshSparse);
+    ++epoch_;
+    tombstones_ = 0;
+    retired_ = 0;
+
+    // 剪掉已无稠密位置的前缀（超过一半才剪，均摊）；窗口因此不超过 2 * kDenseSlack + 两次重建间新发的编号数
+    const auto dead = static_cast<std::size_t>(minDense - slotBase_);
+    if (dead * 2 > slots_.size()) {
+        slots_.erase(slots_.begin(), slots_.begin() + static_cast<std::ptrdiff_t>(dead));
+        slotBase_ += dead;
+    }
+
+    for (auto& kv : auctions_) {
+        auto& levels = kv.second.levels;
+        for (auto it = levels.begin(); it != levels.end();) {
+            if (it->second.buys.live == 0 && it->second.sells.live == 0) it = levels.erase(it);
+            else ++it;
+        }
+    }
+}
+
+std::vector<Trade> MatchingEngine::uncrossBook(const Symbol& sym, AuctionBook& book, const FillHandler& settle) {
+    // 1) 按价位升序展开为数组（跳过已空的价位），累计供给（价格 <= p 的卖量）与需求（价格 >= p 的买量）
+    std::vector<long long> prices;
+    std::vector<std::int64_t> supply;
+    std::vector<std::int64_t> demand;
+    prices.reserve(book.levels.size());
+    supply.reserve(book.levels.size());
+    demand.reserve(book.levels.size());
+
+    std::int64_t acc = book.market.sellQty;
+    for (const auto& kv : book.levels) {
+        if (kv.second.buyQty == 0 && kv.second.sellQty == 0) continue;
+        prices.push_back(kv.first);
+        demand.push_back(kv.second.buyQty);
+        acc += kv.second.sellQty;
+        supply.push_back(acc);
+    }
+    const std::size_t n = prices.size();
+    if (n == 0) return {}; // 只有市价单：无法定价
+
+    acc = book.market.buyQty;
+    for (std::size_t i = n; i-- > 0;) {
+        acc += demand[i];
+        demand[i] = acc;
+    }
+
+    // 2) 选出清价：成交量最大 -> 不平衡量最小 -> 价格最低
+    std::size_t best = 0;
+    std::int64_t bestVol = 0;
+    std::int64_t bestImbalance = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto vol = std::min(demand[i], supply[i]);
+        const auto imbalance = demand[i] > supply[i] ? demand[i] - supply[i] : supply[i] - demand[i];
+        if (vol > bestVol || (vol == bestVol && vol > 0 && imbalance < bestImbalance)) {
+            best = i;
+            bestVol = vol;
+            bestImbalance = imbalance;
+        }
+    }
+    if (bestVol == 0) return {};
+    const Money clearing(prices[best]);
+
+    // 3) 按优先级收集可成交的队列：市价在前，其后买方价高者优先、卖方价低者优先
+    std::vector<AuctionQueue*> buyQueues{&book.market.buys};
+    std::vector<AuctionLevel*> buyLevels{&book.market};
+    for (auto it = book.levels.rbegin(); it != book.levels.rend() && it->first >= prices[best]; ++it) {
+        buyQueues.push_back(&it->second.buys);
+        buyLevels.push_back(&it->second);
+    }
+    std::vector<AuctionQueue*> sellQueues{&book.market.sells};
+    std::vector<AuctionLevel*> sellLevels{&book.market};
+    for (auto it = book.levels.begin(); it != book.levels.end() && it->first <= prices[best]; ++it) {
+        sellQueues.push_back(&it->second.sells);
+        sellLevels.push_back(&it->second);
+    }
+
+    // 4) 双指针沿队列分配 bestVol，跳过墓碑；吃完的订单置 0 成为墓碑
+    // 成交笔数上界：参与队列的订单数之和（每笔成交至少吃完一侧一个订单）
+    std::size_t maxTrades = 0;
+    for (auto* q : buyQueues) maxTrades += q->live;
+    for (auto* q : sellQueues) maxTrades += q->live;
+    std::vector<Trade> trades;
+    trades.reserve(maxTrades);
+
+    auto advance = [](std::vector<AuctionQueue*>& queues, std::size_t& qi, std::size_t& pos) -> AuctionEntry* {
+        for (;;) {
+            auto& entries = queues[qi]->entries;
+            while (pos < entries.size() && entries[pos].qty == 0) ++pos;
+            if (pos < entries.size()) return &entries[pos];
+            if (qi + 1 == queues.size()) return nullptr;
+            pos = queues[++qi]->head;
+        }
+    };
+
+    std::size_t bq = 0, bpos = buyQueues[0]->head;
+    std::size_t sq = 0, spos = sellQueues[0]->head;
+    std::int64_t remaining = bestVol;
+    while (remaining > 0) {
+        AuctionEntry* b = advance(buyQueues, bq, bpos);
+        AuctionEntry* s = advance(sellQueues, sq, spos);
+        if (!b || !s) break; // 仅在有订单被拒后出现：剩余订单不足 bestVol
+        const auto fill = std::min({b->qty, s->qty, remaining});
+
+        Trade t;
+        t.tradeId = nextTradeId_;
+        t.buyOrderId = b->id;
+        t.sellOrderId = s->id;
+        t.symbol = sym;
+        t.qty = fill;
+        t.price = clearing;
+
+        const auto decision = settle ? settle(t, b->qty, s->qty) : FillDecision::Accept;
+        if (decision != FillDecision::Accept) {
+            // 被拒一侧整单移出簿（与吃完同样处理），对手方不动
+            const bool buy = decision == FillDecision::RejectBuy;
+            AuctionEntry& e = buy ? *b : *s;
+            (buy ? buyLevels[bq]->buyQty : sellLevels[sq]->sellQty) -= e.qty;
+            e.qty = 0;
+            --(buy ? buyQueues[bq] : sellQueues[sq])->live;
+            --book.orderCount;
+            --restingCount_;
+            ++retired_;
+            continue;
+        }
+        ++nextTradeId_;
+        trades.push_back(std::move(t));
+
+        b->qty -= fill;
+        s->qty -= fill;
+        buyLevels[bq]->buyQty -= fill;
+        sellLevels[sq]->sellQty -= fill;
+        remaining -= fill;
+        if (b->qty == 0) {
+            --buyQueues[bq]->live;
+            --book.orderCount;
+            --restingCount_;
+            ++retired_;
+        }
+        if (s->qty == 0) {
+            --sellQueues[sq]->live;
+            --book.orderCount;
+            --restingCount_;
+            ++retired_;
+        }
+    }
+
+    // 5) 推进各队列的队首并压缩已出队前缀（位置中的过期项留给重建处理）
+    for (std::size_t j = 0; j <= bq; ++j) compactHead(*buyQueues[j]);
+    for (std::size_t j = 0; j <= sq; ++j) compactHead(*sellQueues[j]);
+    return trades;
+}
+
 } // namespace trade_sim
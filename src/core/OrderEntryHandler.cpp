@@ -0,0 +1,140 @@
+#include "trade_sim/core/OrderEntryHandler.h"
+#include "trade_sim/common/Exceptions.h"
+#include "trade_sim/order/OrderFactory.h"
+
+#include <unordered_set>
+
+namespace trade_sim {
+
+namespace {
+
+WireReport makeReport(ReportType type, const WireMessage& msg) {
+    WireReport r;
+    r.type = static_cast<std::uint8_t>(type);
+    r.clientSeq = msg.clientSeq;
+    r.orderId = msg.orderId;
+    r.qty = msg.qty;
+    r.price = msg.amount;
+    return r;
+}
+
+WireReport makeReject(const WireMessage& msg, ErrorCode code) {
+    WireReport r = makeReport(ReportType::Rejected, msg);
+    r.error = static_cast<std::uint8_t>(code);
+    return r;
+}
+
+} // namespace
+
+void OrderEntryHandler::handle(const WireMessage& msg, std::vector<WireReport>& out) {
+    try {
+        switch (static_cast<MsgType>(msg.type)) {
+        case MsgType::NewOrder: onNewOrder(msg, out); return;
+        case MsgType::Cancel: onCancel(msg, out); return;
+        case MsgType::Deposit: onDeposit(msg, out); return;
+        case MsgType::Amend: onAmend(msg, out); return;
+        }
+        out.push_back(makeReject(msg, ErrorCode::ParseError));
+    } catch (const TradeSimException& e) {
+        out.push_back(makeReject(msg, e.code()));
+    }
+}
+
+void OrderEntryHandler::uncrossAll(std::vector<WireReport>& out) {
+    std::vector<SettlementReject> rejected;
+    try {
+        reportTrades(0, exec_.uncrossAllAndProcess(&rejected), out);
+    } catch (const TradeSimException& e) {
+        // 非结算类错误（如 Continuous 模式）：不针对任何订单
+        out.push_back(makeReject(WireMessage{}, e.code()));
+    }
+    for (const auto& rj : rejected) {
+        WireReport r;
+        r.type = static_cast<std::uint8_t>(ReportType::Rejected);
+        r.error = static_cast<std::uint8_t>(rj.code);
+        r.orderId = rj.orderId;
+        out.push_back(r);
+    }
+}
+
+void OrderEntryHandler::onNewOrder(const WireMessage& msg, std::vector<WireReport>& out) {
+    if (msg.side > 1 || msg.kind > 1) throw InvalidArgumentException("bad side/kind");
+    const auto id = orders_.nextId();
+    const Side side = msg.side == 0 ? Side::Buy : Side::Sell;
+
+    WireMessage echo = msg;
+    echo.orderId = id;
+    try {
+        auto order = msg.kind == 0
+            ? OrderFactory::createMarketOrder(id, wireString(msg.account), wireString(msg.symbol), side, msg.qty)
+            : OrderFactory::createLimitOrder(id, wireString(msg.account), wireString(msg.symbol), side, msg.qty, Money(msg.amount));
+        auto trades = exec_.submitAndProcess(std::move(order));
+        out.push_back(makeReport(ReportType::Accepted, echo));
+        reportTrades(msg.clientSeq, trades, out);
+    } catch (const TradeSimException& e) {
+        out.push_back(makeReject(echo, e.code()));
+    }
+}
+
+void OrderEntryHandler::checkOwner(const WireMessage& msg) const {
+    if (orders_.get(msg.orderId).user() != wireString(msg.account)) throw NotFoundException("order not found");
+}
+
+void OrderEntryHandler::onCancel(const WireMessage& msg, std::vector<WireReport>& out) {
+    checkOwner(msg);
+    exec_.cancel(msg.orderId);
+    out.push_back(makeReport(ReportType::Cancelled, msg));
+}
+
+void OrderEntryHandler::onAmend(const WireMessage& msg, std::vector<WireReport>& out) {
+    checkOwner(msg);
+    const bool keptPriority = exec_.amend(msg.orderId, msg.qty, Money(msg.amount));
+    WireReport r = makeReport(ReportType::Amended, msg);
+    r.error = keptPriority ? 1 : 0;
+    out.push_back(r);
+}
+
+void OrderEntryHandler::onDeposit(const WireMessage& msg, std::vector<WireReport>& out) {
+    if (msg.amount < 0) throw InvalidArgumentException("deposit must be >= 0");
+    if (msg.qty < 0) throw InvalidArgumentException("deposit position must be >= 0");
+    const auto id = wireString(msg.account);
+    const auto sym = wireString(msg.symbol);
+    if (accounts_.exists(id)) {
+        accounts_.getAccount(id).deposit(msg.amount);
+    } else {
+        accounts_.createAccount(id, Money(msg.amount));
+    }
+    if (!sym.empty() && msg.qty > 0) exec_.depositPosition(id, sym, msg.qty);
+    WireReport r = makeReport(ReportType::Deposited, msg);
+    r.price = accounts_.getAccount(id).balance().cents();
+    out.push_back(r);
+}
+
+void OrderEntryHandler::reportTrades(std::uint64_t clientSeq, const std::vector<Trade>& trades,
+                                     std::vector<WireReport>& out) const {
+    const auto first = out.size();
+    for (const auto& t : trades) {
+        WireReport r;
+        r.type = static_cast<std::uint8_t>(ReportType::Trade);
+        r.clientSeq = clientSeq;
+        r.orderId = t.buyOrderId;
+        r.contraId = t.sellOrderId;
+        r.qty = t.qty;
+        r.price = t.price.cents();
+        r.tradeId = t.tradeId;
+        out.push_back(r);
+    }
+    if (trades.empty()) return;
+
+    // 全部成交位只打在该订单本批最后一笔上：倒序扫描，每个订单只看第一次出现
+    std::unordered_set<OrderId> seen;
+    for (auto i = out.size(); i-- > first;) {
+        WireReport& r = out[i];
+        if (seen.insert(r.orderId).second && orders_.status(r.orderId) == OrderStatus::Filled) r.error |= kTradeBuyFilled;
+        if (seen.insert(r.contraId).second && orders_.status(r.contraId) == OrderStatus::Filled) {
+            r.error |= kTradeSellFilled;
+        }
+    }
+}
+
+} // namespace trade_sim
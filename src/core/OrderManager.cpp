@@ -20,6 +20,19 @@ void OrderManager::submitRaw(Order* rawOrder) {
     submit(std::unique_ptr<Order>(rawOrder));
 }
 
+void OrderManager::restore(std::unique_ptr<Order> order, OrderStatus status) {
+    if (!order) throw InvalidArgumentException("restore: order is null");
+    const auto id = order->id();
+    if (orders_.find(id) != orders_.end()) throw TradeSimException(ErrorCode::Duplicate, "orderId duplicate");
+    status_[id] = status;
+    orders_[id] = std::move(order);
+}
+
+void OrderManager::restoreNextId(OrderId next) {
+    if (next < next_) throw TradeSimException(ErrorCode::InvalidState, "next order id cannot move backwards");
+    next_ = next;
+}
+
 Order& OrderManager::get(OrderId id) {
     auto it = orders_.find(id);
     if (it == orders_.end()) throw NotFoundException("order not found");
@@ -42,8 +55,44 @@ void OrderManager::cancel(OrderId id) {
     auto it = status_.find(id);
     if (it == status_.end()) throw NotFoundException("order not found");
     if (it->second == OrderStatus::Filled) throw TradeSimException(ErrorCode::InvalidState, "filled order cannot cancel");
+    if (it->second != OrderStatus::Pending && it->second != OrderStatus::PartiallyFilled) {
+        throw TradeSimException(ErrorCode::InvalidState, "order is no longer active");
+    }
     it->second = OrderStatus::Cancelled;
-    // TODO：撮合队列里也要移除（后续扩展 OrderBook 时做）
+}
+
+void OrderManager::fill(OrderId id, bool complete) {
+    auto it = status_.find(id);
+    if (it == status_.end()) throw NotFoundException("order not found");
+    if (it->second != OrderStatus::Pending && it->second != OrderStatus::PartiallyFilled) {
+        throw TradeSimException(ErrorCode::InvalidState, "order cannot be filled");
+    }
+    it->second = complete ? OrderStatus::Filled : OrderStatus::PartiallyFilled;
+}
+
+void OrderManager::reject(OrderId id) {
+    auto it = status_.find(id);
+    if (it == status_.end()) throw NotFoundException("order not found");
+    if (it->second != OrderStatus::Pending && it->second != OrderStatus::PartiallyFilled) {
+        throw TradeSimException(ErrorCode::InvalidState, "order cannot be rejected");
+    }
+    it->second = OrderStatus::Rejected;
+}
+
+void OrderManager::amend(OrderId id, std::int64_t newQty, Money newLimit) {
+    auto it = orders_.find(id);
+    if (it == orders_.end()) throw NotFoundException("order not found");
+    const auto st = status(id);
+    if (st != OrderStatus::Pending && st != OrderStatus::PartiallyFilled) {
+        throw TradeSimException(ErrorCode::InvalidState, "order cannot be amended");
+    }
+    Order& order = *(it->second);
+    if (newQty <= 0) throw InvalidArgumentException("amend qty must be > 0");
+    if (order.kind() == OrderKind::Market ? newLimit.cents() != 0 : newLimit.cents() <= 0) {
+        throw InvalidArgumentException("amend limit price invalid for order kind");
+    }
+    order.amendLimitPrice(newLimit);
+    order.amendQty(newQty);
 }
 
 } // namespace trade_sim
@@ -1,30 +1,135 @@
 #include "trade_sim/core/TradeExecutor.h"
 #include "trade_sim/common/Exceptions.h"
+#include "trade_sim/core/FlightRecorder.h"
 
 namespace trade_sim {
 
-void TradeExecutor::submitAndProcess(std::unique_ptr<Order> order) {
+namespace {
+
+void recordMatched(const std::vector<Trade>& trades) noexcept {
+    for (const auto& t : trades) {
+        FlightRecorder::recordTrade(FlightEvent::Matched, t.tradeId, t.buyOrderId, t.sellOrderId, t.qty, t.price);
+    }
+}
+
+} // namespace
+
+std::vector<Trade> TradeExecutor::submitAndProcess(std::unique_ptr<Order> order) {
     if (!order) throw InvalidArgumentException("submitAndProcess: null order");
 
     // 1) 入库（OrderManager 持有所有权）
     const auto oid = order->id();
-    orders_.submit(std::move(order));
+    try {
+        orders_.submit(std::move(order));
+        const Order& ref = orders_.get(oid);
+        FlightRecorder::record(FlightEvent::Accepted, oid, ref.side(), ref.qty(), ref.limitPrice());
+
+        // 2) 撮合
+        auto trades = engine_.match(ref);
+        recordMatched(trades);
 
-    // 2) 撮合
-    const Order& ref = orders_.get(oid);
-    auto trades = engine_.match(ref);
+        // 3) 应用成交 + 记录历史
+        settle(trades);
 
-    // 3) 应用成交 + 记录历史
+        return trades;
+    } catch (const TradeSimException& e) {
+        FlightRecorder::recordReject(oid, e.code());
+        throw;
+    }
+}
+
+void TradeExecutor::cancel(OrderId id) {
+    orders_.cancel(id);
+    const Order& order = orders_.get(id);
+    engine_.cancel(order);
+    FlightRecorder::record(FlightEvent::Cancelled, id, order.side(), order.qty(), Money(0));
+}
+
+void TradeExecutor::depositPosition(const AccountId& id, const Symbol& sym, std::int64_t qty) {
+    if (qty <= 0) throw InvalidArgumentException("deposit position must be > 0");
+    accounts_.getAccount(id).addPosition(sym, qty);
+    if (valuation_) valuation_->importPosition(id, sym, qty);
+}
+
+void TradeExecutor::attachValuation(ValuationEngine* valuation) {
+    if (valuation && valuation->positionCount() != 0) {
+        throw TradeSimException(ErrorCode::InvalidState, "valuation engine must be empty when attached");
+    }
+    if (valuation) {
+        accounts_.forEachAccount([valuation](const Account& a) {
+            a.forEachPosition([&](const Symbol& sym, std::int64_t qty) { valuation->importPosition(a.id(), sym, qty); });
+        });
+    }
+    valuation_ = valuation;
+}
+
+bool TradeExecutor::amend(OrderId id, std::int64_t newQty, Money newLimit) {
+    const Order& order = orders_.get(id);
+    const auto st = orders_.status(id);
+    if (st != OrderStatus::Pending && st != OrderStatus::PartiallyFilled) {
+        throw TradeSimException(ErrorCode::InvalidState, "order cannot be amended");
+    }
+
+    // engine 读取改单前的 order 计算已成交量，并完成剩余校验；之后 OrderManager 不会再失败
+    const bool keptPriority = engine_.amend(order, newQty, newLimit);
+    orders_.amend(id, newQty, newLimit);
+    FlightRecorder::record(FlightEvent::Amended, id, order.side(), newQty, newLimit);
+    return keptPriority;
+}
+
+std::vector<Trade> TradeExecutor::uncrossAndProcess(const Symbol& sym, std::vector<SettlementReject>* rejected) {
+    return engine_.uncross(sym, [this, rejected](const Trade& t, std::int64_t buyLeaves, std::int64_t sellLeaves) {
+        return settleFill(t, buyLeaves, sellLeaves, rejected);
+    });
+}
+
+std::vector<Trade> TradeExecutor::uncrossAllAndProcess(std::vector<SettlementReject>* rejected) {
+    return engine_.uncrossAll([this, rejected](const Trade& t, std::int64_t buyLeaves, std::int64_t sellLeaves) {
+        return settleFill(t, buyLeaves, sellLeaves, rejected);
+    });
+}
+
+void TradeExecutor::settle(const std::vector<Trade>& trades) {
     for (const auto& t : trades) {
-        applyTradeToAccounts(t);
-        // TODO：buyer/seller 如何确定：根据订单方向映射 orderId -> userId
-        // 暂时先不写死
-        const auto& buyOrder=orders_.get(t.buyOrderId);
-        const auto& sellOrder=orders_.get(t.sellOrderId);
-        history_.record(t, buyOrder.user(), sellOrder.user());
+        try {
+            applyTradeToAccounts(t);
+        } catch (const TradeSimException& e) {
+            FlightRecorder::recordTradeReject(t.tradeId, t.buyOrderId, t.sellOrderId, e.code());
+            throw;
+        }
+        recordSettled(t);
+    }
+}
+
+FillDecision TradeExecutor::settleFill(const Trade& t, std::int64_t buyLeaves, std::int64_t sellLeaves,
+                                       std::vector<SettlementReject>* rejected) {
+    FlightRecorder::recordTrade(FlightEvent::Matched, t.tradeId, t.buyOrderId, t.sellOrderId, t.qty, t.price);
+    try {
+        applyTradeToAccounts(t); // 失败时账户不变
+    } catch (const TradeSimException& e) {
+        FlightRecorder::recordTradeReject(t.tradeId, t.buyOrderId, t.sellOrderId, e.code());
+        // 责任方：持仓不足或卖方账户不存在算卖方，其余（资金不足等）算买方
+        const bool sellSide = e.code() == ErrorCode::InsufficientPosition ||
+                              !accounts_.exists(orders_.get(t.sellOrderId).user());
+        const OrderId victim = sellSide ? t.sellOrderId : t.buyOrderId;
+        orders_.reject(victim);
+        if (rejected) rejected->push_back(SettlementReject{victim, e.code()});
+        return sellSide ? FillDecision::RejectSell : FillDecision::RejectBuy;
     }
+    orders_.fill(t.buyOrderId, t.qty == buyLeaves);
+    orders_.fill(t.sellOrderId, t.qty == sellLeaves);
+    recordSettled(t);
+    return FillDecision::Accept;
+}
 
-    // TODO：更新订单状态 Pending -> Filled / PartiallyFilled
+void TradeExecutor::recordSettled(const Trade& t) {
+    FlightRecorder::recordTrade(FlightEvent::Settled, t.tradeId, t.buyOrderId, t.sellOrderId, t.qty, t.price);
+    // TODO：buyer/seller 如何确定：根据订单方向映射 orderId -> userId
+    // 暂时先不写死
+    const auto& buyOrder=orders_.get(t.buyOrderId);
+    const auto& sellOrder=orders_.get(t.sellOrderId);
+    history_.record(t, buyOrder.user(), sellOrder.user());
+    FlightRecorder::recordTrade(FlightEvent::HistoryRecorded, t.tradeId, t.buyOrderId, t.sellOrderId, t.qty, t.price);
 }
 
 void TradeExecutor::applyTradeToAccounts(const Trade& t) {
@@ -67,6 +172,8 @@ void TradeExecutor::applyTradeToAccounts(const Trade& t) {
     buyer.withdraw(notional);
     seller.deposit(notional);
     seller.addPosition(t.symbol, -t.qty);
+
+    if (valuation_) valuation_->onTrade(t, buyer.id(), seller.id());
 }
 
 } // namespace trade_sim
@@ -0,0 +1,170 @@
+#include "trade_sim/core/ValuationEngine.h"
+#include "trade_sim/common/Exceptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace trade_sim {
+
+void ValuationEngine::onTrade(const Trade& t, const AccountId& buyer, const AccountId& seller) {
+    applyFill(buyer, t.symbol, t.qty, t.price);
+    applyFill(seller, t.symbol, -t.qty, t.price);
+}
+
+void ValuationEngine::applyFill(const AccountId& account, const Symbol& sym, std::int64_t deltaQty, Money price) {
+    const auto a = accountIndex(account);
+    const auto s = symbolIndex(sym);
+    const auto i = slotIndex(a, s);
+
+    const auto oldQty = posQty_[i];
+    const auto oldCost = posCost_[i];
+    auto newQty = oldQty;
+    auto newCost = oldCost;
+    auto opening = deltaQty;
+    if ((oldQty > 0 && deltaQty < 0) || (oldQty < 0 && deltaQty > 0)) {
+        // 平均成本法：先按平仓比例结转成本（多头卖出 / 空头买回），成本与数量同号
+        const auto absOld = std::llabs(oldQty);
+        const auto closing = std::min<std::int64_t>(std::llabs(deltaQty), absOld);
+        const long long removed = closing == absOld
+            ? oldCost
+            : static_cast<long long>(std::llround(static_cast<long double>(oldCost) * closing / absOld));
+        const long long sign = oldQty > 0 ? 1 : -1;
+        realized_[a] += sign * closing * price.cents() - removed;
+        newQty -= sign * closing;
+        newCost -= removed;
+        opening = deltaQty + sign * closing;
+    }
+    // 余量（含穿越 0 的部分）按成交价开新仓
+    newQty += opening;
+    newCost += opening * price.cents();
+
+    if (oldQty == 0 && newQty != 0) addHolder(i);
+    posQty_[i] = newQty;
+    posCost_[i] = newCost;
+    if (oldQty != 0 && newQty == 0) removeHolder(i);
+    cost_[a] += newCost - oldCost;
+    marketValue_[a] += (newQty - oldQty) * lastPx_[s];
+    gross_[a] += (std::llabs(newQty) - std::llabs(oldQty)) * lastPx_[s];
+}
+
+void ValuationEngine::importPosition(const AccountId& account, const Symbol& sym, std::int64_t qty) {
+    if (qty < 0) throw InvalidArgumentException("imported position must be >= 0");
+    if (qty == 0) return;
+    applyFill(account, sym, qty, lastPrice(sym));
+}
+
+void ValuationEngine::onPrice(const Symbol& sym, Money last) {
+    if (last.cents() < 0) throw InvalidArgumentException("price must be >= 0");
+    const auto s = symbolIndex(sym);
+    const auto delta = last.cents() - lastPx_[s];
+    lastPx_[s] = last.cents();
+    if (delta == 0) return;
+
+    for (auto i : holders_[s]) {
+        const auto q = posQty_[i];
+        const auto a = posAccount_[i];
+        marketValue_[a] += q * delta;
+        gross_[a] += std::llabs(q) * delta;
+    }
+}
+
+void ValuationEngine::revalueAll() {
+    const auto n = posQty_.size();
+
+    // 1) 逐槽估值：无分支的顺序循环，便于编译器向量化
+    std::vector<long long> value(n);
+    const auto* qty = posQty_.data();
+    const auto* sym = posSymbol_.data();
+    const auto* px = lastPx_.data();
+    for (std::size_t i = 0; i < n; ++i) value[i] = qty[i] * px[sym[i]];
+
+    // 2) 按账户归集（标记价 >= 0，|qty * px| = |qty| * px）
+    std::fill(marketValue_.begin(), marketValue_.end(), 0);
+    std::fill(gross_.begin(), gross_.end(), 0);
+    const auto* acct = posAccount_.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        marketValue_[acct[i]] += value[i];
+        gross_[acct[i]] += std::llabs(value[i]);
+    }
+}
+
+AccountValuation ValuationEngine::valuationOf(const AccountId& id) const {
+    auto it = accountIdx_.find(id);
+    if (it == accountIdx_.end()) throw NotFoundException("no valuation for account: " + id);
+    const auto a = it->second;
+
+    AccountValuation v;
+    v.realizedPnl = Money(realized_[a]);
+    v.unrealizedPnl = Money(marketValue_[a] - cost_[a]);
+    v.marketValue = Money(marketValue_[a]);
+    v.grossExposure = Money(gross_[a]);
+    return v;
+}
+
+Money ValuationEngine::lastPrice(const Symbol& sym) const noexcept {
+    auto it = symbolIdx_.find(sym);
+    return it == symbolIdx_.end() ? Money(0) : Money(lastPx_[it->second]);
+}
+
+std::size_t ValuationEngine::holderCount(const Symbol& sym) const noexcept {
+    auto it = symbolIdx_.find(sym);
+    return it == symbolIdx_.end() ? 0 : holders_[it->second].size();
+}
+
+std::uint32_t ValuationEngine::accountIndex(const AccountId& id) {
+    auto it = accountIdx_.find(id);
+    if (it != accountIdx_.end()) return it->second;
+
+    const auto a = static_cast<std::uint32_t>(realized_.size());
+    accountIdx_.emplace(id, a);
+    realized_.push_back(0);
+    cost_.push_back(0);
+    marketValue_.push_back(0);
+    gross_.push_back(0);
+    return a;
+}
+
+std::uint32_t ValuationEngine::symbolIndex(const Symbol& sym) {
+    auto it = symbolIdx_.find(sym);
+    if (it != symbolIdx_.end()) return it->second;
+
+    const auto s = static_cast<std::uint32_t>(lastPx_.size());
+    symbolIdx_.emplace(sym, s);
+    lastPx_.push_back(0);
+    holders_.emplace_back();
+    return s;
+}
+
+std::uint32_t ValuationEngine::slotIndex(std::uint32_t account, std::uint32_t symbol) {
+    const auto key = (static_cast<std::uint64_t>(account) << 32) | symbol;
+    auto it = slotIdx_.find(key);
+    if (it != slotIdx_.end()) return it->second;
+
+    const auto i = static_cast<std::uint32_t>(posQty_.size());
+    slotIdx_.emplace(key, i);
+    posAccount_.push_back(account);
+    posSymbol_.push_back(symbol);
+    posQty_.push_back(0);
+    posCost_.push_back(0);
+    posHolder_.push_back(kNotHeld);
+    return i;
+}
+
+void ValuationEngine::addHolder(std::uint32_t slot) {
+    auto& list = holders_[posSymbol_[slot]];
+    posHolder_[slot] = static_cast<std::uint32_t>(list.size());
+    list.push_back(slot);
+}
+
+void ValuationEngine::removeHolder(std::uint32_t slot) noexcept {
+    // 与末尾交换后弹出，O(1)
+    auto& list = holders_[posSymbol_[slot]];
+    const auto at = posHolder_[slot];
+    list[at] = list.back();
+    posHolder_[list[at]] = at;
+    list.pop_back();
+    posHolder_[slot] = kNotHeld;
+}
+
+} // namespace trade_sim
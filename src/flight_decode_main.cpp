@@ -0,0 +1,99 @@
+#include "trade_sim/common/Exceptions.h"
+#include "trade_sim/core/FlightRecorder.h"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+using namespace trade_sim;
+
+/**
+ * trade_sim_flight：飞行记录转储的离线解码
+ * 用法：trade_sim_flight DUMP [--thread N]
+ * - 每条记录一行：环编号、序号、距转储时刻（微秒）、事件及字段
+ */
+namespace {
+
+const char* eventName(std::uint8_t type) {
+    switch (static_cast<FlightEvent>(type)) {
+        case FlightEvent::Accepted: return "ACCEPTED";
+        case FlightEvent::Matched: return "MATCHED";
+        case FlightEvent::Settled: return "SETTLED";
+        case FlightEvent::Rejected: return "REJECTED";
+        case FlightEvent::HistoryRecorded: return "HISTORY";
+        case FlightEvent::Cancelled: return "CANCELLED";
+        case FlightEvent::Amended: return "AMENDED";
+    }
+    return "UNKNOWN";
+}
+
+const char* errorName(std::uint8_t code) {
+    switch (static_cast<ErrorCode>(code)) {
+        case ErrorCode::InvalidArgument: return "InvalidArgument";
+        case ErrorCode::NotFound: return "NotFound";
+        case ErrorCode::Duplicate: return "Duplicate";
+        case ErrorCode::InsufficientFunds: return "InsufficientFunds";
+        case ErrorCode::InsufficientPosition: return "InsufficientPosition";
+        case ErrorCode::IOError: return "IOError";
+        case ErrorCode::ParseError: return "ParseError";
+        case ErrorCode::InvalidState: return "InvalidState";
+    }
+    return "Unknown";
+}
+
+void print(const FlightDump& d, const FlightRecord& r) {
+    std::printf("t%-3u #%-10llu %+14.3fus %-9s ", r.thread, static_cast<unsigned long long>(r.seq),
+                d.nanosBeforeDump(r.ticks) / 1000.0, eventName(r.type));
+    switch (static_cast<FlightEvent>(r.type)) {
+        case FlightEvent::Matched:
+        case FlightEvent::Settled:
+        case FlightEvent::HistoryRecorded:
+            std::printf("trade=%llu buy=%llu sell=%llu qty=%lld px=%lld\n",
+                        static_cast<unsigned long long>(r.tradeId), static_cast<unsigned long long>(r.orderId),
+                        static_cast<unsigned long long>(r.contraId), static_cast<long long>(r.qty),
+                        static_cast<long long>(r.price));
+            break;
+        case FlightEvent::Rejected:
+            if (r.tradeId) {
+                std::printf("trade=%llu buy=%llu sell=%llu error=%s\n", static_cast<unsigned long long>(r.tradeId),
+                            static_cast<unsigned long long>(r.orderId), static_cast<unsigned long long>(r.contraId),
+                            errorName(r.error));
+            } else {
+                std::printf("order=%llu error=%s\n", static_cast<unsigned long long>(r.orderId), errorName(r.error));
+            }
+            break;
+        default:
+            std::printf("order=%llu side=%s qty=%lld px=%lld\n", static_cast<unsigned long long>(r.orderId),
+                        r.side ? "SELL" : "BUY", static_cast<long long>(r.qty), static_cast<long long>(r.price));
+            break;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        if (argc != 2 && !(argc == 4 && std::string(argv[2]) == "--thread")) {
+            throw InvalidArgumentException("usage: trade_sim_flight DUMP [--thread N]");
+        }
+        const long thread = argc == 4 ? std::stol(argv[3]) : -1;
+
+        const auto dump = FlightRecorder::load(argv[1]);
+        std::size_t shown = 0;
+        for (const auto& r : dump.records) {
+            if (thread >= 0 && r.thread != static_cast<std::uint32_t>(thread)) continue;
+            print(dump, r);
+            ++shown;
+        }
+        std::cerr << "rings=" << dump.header.ringCount << " records=" << dump.records.size() << " shown=" << shown
+                  << "\n";
+    } catch (const TradeSimException& e) {
+        std::cerr << "[TradeSimException] code=" << static_cast<int>(e.code()) << " msg=" << e.what() << "\n";
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "[std::exception] " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include "trade_sim/common/Exceptions.h"
+#include "trade_sim/core/AccountManager.h"
+#include "trade_sim/core/FlightRecorder.h"
+#include "trade_sim/core/HistoryManager.h"
+#include "trade_sim/core/MatchingEngine.h"
+#include "trade_sim/core/OrderEntryHandler.h"
+#include "trade_sim/core/OrderManager.h"
+#include "trade_sim/core/TradeExecutor.h"
+#include "trade_sim/net/OrderGateway.h"
+#include "trade_sim/net/Replication.h"
+
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+
+using namespace trade_sim;
+
+/**
+ * trade_sim_gateway：本机 socket 订单网关
+ * 用法：trade_sim_gateway (--unix PATH | --tcp PORT) [--auction MS] [--flight DUMP]
+ *                         [--replica SOCK [--replica-sync MS] | --standby SOCK]
+ * - SIGINT / SIGTERM 退出事件循环
+ * - --replica SOCK：主节点，启动时连接 SOCK 上的备节点，之后每条输入按序异步复制过去（不等待备节点确认）
+ *   注意：客户端收到的 Accepted / Trade 可能尚未到达备节点，主节点此时被杀则接管后这些订单丢失
+ * - --replica-sync MS：同步复制，每轮回写客户端前等待备节点确认（最多 MS 毫秒，超时退化为异步），消除上述丢失窗口
+ * - --standby SOCK：备节点，在 SOCK 上等待主节点并应用其输入；主节点断开后接管，开始监听 --unix / --tcp
+ * - --flight DUMP：异常退出（含 std::terminate）时把飞行记录转储到 DUMP
+ */
+namespace {
+
+OrderGateway* g_gateway = nullptr;
+ReplicationStandby* g_standby = nullptr;
+
+void onSignal(int) {
+    if (g_standby) g_standby->stop();
+    if (g_gateway) g_gateway->stop();
+}
+
+/** 数千连接需要放开 fd 软上限 */
+void raiseFdLimit() {
+    rlimit lim{};
+    if (::getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < lim.rlim_max) {
+        lim.rlim_cur = lim.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &lim);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string flightDump;
+    try {
+        std::string replicaPath;
+        std::string standbyPath;
+        GatewayConfig cfg;
+        bool haveAddress = false;
+        for (int i = 1; i + 1 < argc; i += 2) {
+            const std::string arg = argv[i];
+            if (arg == "--unix") {
+                cfg.unixPath = argv[i + 1];
+                haveAddress = true;
+            } else if (arg == "--tcp") {
+                cfg.tcpPort = static_cast<std::uint16_t>(std::atoi(argv[i + 1]));
+                haveAddress = true;
+            } else if (arg == "--auction") {
+                cfg.auctionIntervalMs = std::atoi(argv[i + 1]);
+            } else if (arg == "--flight") {
+                flightDump = argv[i + 1];
+            } else if (arg == "--replica") {
+                replicaPath = argv[i + 1];
+            } else if (arg == "--replica-sync") {
+                cfg.replicationSyncMs = std::atoi(argv[i + 1]);
+            } else if (arg == "--standby") {
+                standbyPath = argv[i + 1];
+            } else {
+                haveAddress = false;
+                break;
+            }
+        }
+        if (!haveAddress || argc % 2 == 0 || (!replicaPath.empty() && !standbyPath.empty()) ||
+            (cfg.replicationSyncMs > 0 && replicaPath.empty())) {
+            throw InvalidArgumentException("usage: trade_sim_gateway (--unix PATH | --tcp PORT) [--auction MS] [--flight DUMP] "
+                                           "[--replica SOCK [--replica-sync MS] | --standby SOCK]");
+        }
+        raiseFdLimit();
+        if (!flightDump.empty()) FlightRecorder::installTerminateHandler(flightDump);
+
+        AccountManager am;
+        OrderManager om;
+        MatchingEngine me(cfg.auctionIntervalMs > 0 ? MatchingMode::Auction : MatchingMode::Continuous);
+        HistoryManager hm;
+        TradeExecutor exec(am, om, me, hm);
+        OrderEntryHandler handler(am, om, exec);
+        OrderGateway gateway(handler, cfg);
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+
+        if (!standbyPath.empty()) {
+            ReplicationConfig rcfg;
+            rcfg.unixPath = standbyPath;
+            ReplicationStandby standby(handler, rcfg);
+            standby.listen();
+            std::cerr << "standby waiting for primary on " << standbyPath << "\n";
+            g_standby = &standby;
+            const bool primaryLost = standby.run();
+            g_standby = nullptr;
+            if (!primaryLost) {
+                std::cerr << "standby stopped at seq " << standby.appliedSeq() << "\n";
+                return 0;
+            }
+            std::cerr << "primary lost at seq " << standby.appliedSeq() << ", taking over\n";
+        }
+
+        ReplicationConfig replicaCfg;
+        replicaCfg.unixPath = replicaPath;
+        ReplicationPublisher replica(replicaCfg);
+        if (!replicaPath.empty()) {
+            replica.connect();
+            gateway.attachReplication(&replica);
+        }
+
+        const auto port = gateway.listen();
+        if (cfg.unixPath.empty()) {
+            std::cerr << "listening on 127.0.0.1:" << port << "\n";
+        } else {
+            std::cerr << "listening on " << cfg.unixPath << "\n";
+        }
+
+        g_gateway = &gateway;
+        gateway.run();
+        g_gateway = nullptr;
+        const bool replicaHealthy = replica.healthy();
+        replica.close();
+
+        std::cerr << "stopped, sessions=" << gateway.sessionCount()
+                  << " settlement_rejects=" << gateway.settlementRejects()
+                  << " dropped_connections=" << gateway.droppedConnections();
+        if (!replicaPath.empty()) {
+            std::cerr << " replicated=" << replica.publishedSeq() << " acked=" << replica.ackedSeq()
+                      << (replicaHealthy ? "" : " (standby lost)");
+            if (cfg.replicationSyncMs > 0) std::cerr << " sync_timeouts=" << gateway.replicationSyncTimeouts();
+        }
+        std::cerr << "\n";
+    } catch (const TradeSimException& e) {
+        std::cerr << "[TradeSimException] code=" << static_cast<int>(e.code()) << " msg=" << e.what() << "\n";
+        FlightRecorder::dumpNoThrow(flightDump);
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "[std::exception] " << e.what() << "\n";
+        FlightRecorder::dumpNoThrow(flightDump);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,305 @@
+#include "trade_sim/io/Snapshot.h"
+#include "trade_sim/core/AccountManager.h"
+#include "trade_sim/core/HistoryManager.h"
+#include "trade_sim/core/MatchingEngine.h"
+#include "trade_sim/core/OrderManager.h"
+#include "trade_sim/order/OrderFactory.h"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TRADE_SIM_SNAPSHOT_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace trade_sim {
+
+namespace {
+
+constexpr std::size_t kRecordBytes[kSnapshotSectionCount] = {
+    sizeof(char),             // Strings
+    sizeof(SnapshotString),   // Symbols
+    sizeof(SnapshotAccount),  // Accounts
+    sizeof(SnapshotPosition), // Positions
+    sizeof(SnapshotSlot),     // AccountSlots
+    sizeof(SnapshotOrder),    // Orders
+    sizeof(SnapshotTrade),    // Trades
+    sizeof(SnapshotString),   // HistoryUsers
+    sizeof(SnapshotSlot),     // HistoryUserSlots
+    sizeof(std::uint64_t),    // HistoryOffsets
+    sizeof(std::uint32_t),    // HistoryEntries
+};
+
+constexpr std::size_t kWriteBufferBytes = 1 << 20;
+
+} // namespace
+
+// ---------------- SnapshotWriter ----------------
+
+SnapshotWriter::SnapshotWriter(std::string path) : path_(std::move(path)), tmpPath_(path_ + ".tmp") {
+    file_ = std::fopen(tmpPath_.c_str(), "wb");
+    if (!file_) throw IOErrorException("cannot open file for write: " + tmpPath_);
+    std::setvbuf(file_, nullptr, _IOFBF, kWriteBufferBytes);
+    writeRaw(&header_, sizeof(header_)); // 占位，commit 时回填
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    if (file_) {
+        std::fclose(file_);
+        std::remove(tmpPath_.c_str());
+    }
+}
+
+SnapshotString SnapshotWriter::addString(std::string_view s) {
+    if (strings_.size() + s.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw TradeSimException(ErrorCode::InvalidState, "snapshot string pool exceeds 4 GiB");
+    }
+    const SnapshotString ref{static_cast<std::uint32_t>(strings_.size()), static_cast<std::uint32_t>(s.size())};
+    strings_.insert(strings_.end(), s.begin(), s.end());
+    return ref;
+}
+
+void SnapshotWriter::begin(SnapshotSection section, std::size_t recordBytes) {
+    const auto idx = static_cast<std::size_t>(section);
+    if (current_ != -1 || idx >= kSnapshotSectionCount || recordBytes != kRecordBytes[idx]) {
+        throw TradeSimException(ErrorCode::InvalidState, "snapshot section begin out of order");
+    }
+    static const char zeros[kSnapshotAlign] = {};
+    if (const auto pad = (kSnapshotAlign - offset_ % kSnapshotAlign) % kSnapshotAlign) writeRaw(zeros, pad);
+    header_.sections[idx].offset = offset_;
+    current_ = static_cast<int>(idx);
+    recordBytes_ = recordBytes;
+    sectionBytes_ = 0;
+}
+
+void SnapshotWriter::append(const void* data, std::size_t bytes) {
+    if (current_ == -1) throw TradeSimException(ErrorCode::InvalidState, "snapshot append outside section");
+    writeRaw(data, bytes);
+    sectionBytes_ += bytes;
+}
+
+void SnapshotWriter::end() {
+    if (current_ == -1 || sectionBytes_ % recordBytes_ != 0) {
+        throw TradeSimException(ErrorCode::InvalidState, "snapshot section end out of order");
+    }
+    header_.sections[current_].count = sectionBytes_ / recordBytes_;
+    current_ = -1;
+}
+
+void SnapshotWriter::commit() {
+    writeSection(SnapshotSection::Strings, strings_.data(), strings_.size());
+
+    std::memcpy(header_.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header_.version = kSnapshotVersion;
+    header_.headerBytes = sizeof(SnapshotHeader);
+    header_.fileBytes = offset_;
+    header_.hashProbe = snapshotHashProbe();
+
+    if (std::fseek(file_, 0, SEEK_SET) != 0 || std::fwrite(&header_, sizeof(header_), 1, file_) != 1 ||
+        std::fflush(file_) != 0) {
+        throw IOErrorException("write snapshot header failed: " + tmpPath_);
+    }
+#ifdef TRADE_SIM_SNAPSHOT_MMAP
+    if (::fsync(::fileno(file_)) != 0) throw IOErrorException("fsync snapshot failed: " + tmpPath_);
+#endif
+    const int rc = std::fclose(file_);
+    file_ = nullptr;
+    if (rc != 0 || std::rename(tmpPath_.c_str(), path_.c_str()) != 0) {
+        std::remove(tmpPath_.c_str());
+        throw IOErrorException("commit snapshot failed: " + path_);
+    }
+}
+
+void SnapshotWriter::writeRaw(const void* data, std::size_t bytes) {
+    if (bytes && std::fwrite(data, 1, bytes, file_) != bytes) {
+        throw IOErrorException("write snapshot failed: " + tmpPath_);
+    }
+    offset_ += bytes;
+}
+
+// ---------------- SnapshotView ----------------
+
+std::shared_ptr<const SnapshotView> SnapshotView::open(const std::string& path) {
+    std::shared_ptr<SnapshotView> v(new SnapshotView());
+#ifdef TRADE_SIM_SNAPSHOT_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw IOErrorException("cannot open file for read: " + path);
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw IOErrorException("cannot stat file: " + path);
+    }
+    v->bytes_ = static_cast<std::size_t>(st.st_size);
+    if (v->bytes_ > 0) {
+        void* p = ::mmap(nullptr, v->bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw IOErrorException("cannot mmap file: " + path);
+        }
+        v->base_ = static_cast<const char*>(p);
+        v->mapped_ = true;
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) throw IOErrorException("cannot open file for read: " + path);
+    v->buffer_.resize(static_cast<std::size_t>(in.tellg()));
+    in.seekg(0);
+    if (!in.read(v->buffer_.data(), static_cast<std::streamsize>(v->buffer_.size()))) {
+        throw IOErrorException("read snapshot failed: " + path);
+    }
+    v->base_ = v->buffer_.data();
+    v->bytes_ = v->buffer_.size();
+#endif
+    v->validate(path);
+    return v;
+}
+
+SnapshotView::~SnapshotView() {
+#ifdef TRADE_SIM_SNAPSHOT_MMAP
+    if (mapped_) ::munmap(const_cast<char*>(base_), bytes_);
+#endif
+}
+
+void SnapshotView::validate(const std::string& path) {
+    if (bytes_ < sizeof(SnapshotHeader)) throw ParseErrorException("snapshot too small: " + path);
+    std::memcpy(&header_, base_, sizeof(header_));
+    if (std::memcmp(header_.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+        throw ParseErrorException("not a snapshot: " + path);
+    }
+    if (header_.version != kSnapshotVersion || header_.headerBytes != sizeof(SnapshotHeader)) {
+        throw ParseErrorException("unsupported snapshot version: " + path);
+    }
+    if (header_.fileBytes != bytes_) throw ParseErrorException("truncated snapshot: " + path);
+
+    for (std::size_t i = 0; i < kSnapshotSectionCount; ++i) {
+        const auto& e = header_.sections[i];
+        if (e.count == 0) continue;
+        const bool inside = e.offset >= sizeof(SnapshotHeader) && e.offset <= bytes_ &&
+                            e.count <= (bytes_ - e.offset) / kRecordBytes[i];
+        if (!inside || e.offset % kSnapshotAlign != 0) throw ParseErrorException("corrupt snapshot section: " + path);
+    }
+
+    const auto users = header_.sections[static_cast<std::size_t>(SnapshotSection::HistoryUsers)].count;
+    const auto offsets = header_.sections[static_cast<std::size_t>(SnapshotSection::HistoryOffsets)].count;
+    if (users != 0 && offsets != users + 1) throw ParseErrorException("corrupt snapshot history index: " + path);
+
+    // symbol 只有数十到数千个：打开时全部驻留
+    const auto syms = section<SnapshotString>(SnapshotSection::Symbols);
+    symbols_.reserve(syms.size);
+    for (const auto& s : syms) symbols_.push_back(SymbolTable::intern(Symbol(string(s))));
+}
+
+std::string_view SnapshotView::string(SnapshotString s) const {
+    const auto pool = section<char>(SnapshotSection::Strings);
+    if (s.offset > pool.size || s.length > pool.size - s.offset) {
+        throw ParseErrorException("snapshot string out of range");
+    }
+    return std::string_view(pool.data + s.offset, s.length);
+}
+
+SymbolTable::Code SnapshotView::symbol(std::uint32_t snapshotCode) const {
+    if (snapshotCode >= symbols_.size()) throw ParseErrorException("snapshot symbol out of range");
+    return symbols_[snapshotCode];
+}
+
+// ---------------- Snapshot ----------------
+
+void Snapshot::save(const std::string& path, const AccountManager& am, const OrderManager& om,
+                    const MatchingEngine& me, const HistoryManager& hm) {
+    SnapshotWriter w(path);
+    am.saveSnapshot(w);
+
+    w.begin(SnapshotSection::Orders, sizeof(SnapshotOrder));
+    me.forEachResting([&](OrderId id, std::int64_t remaining) {
+        const Order& o = om.get(id);
+        SnapshotOrder r;
+        r.id = id;
+        r.account = w.addString(o.user());
+        r.symbol = SymbolTable::intern(o.symbol());
+        r.side = static_cast<std::uint8_t>(o.side());
+        r.kind = static_cast<std::uint8_t>(o.kind());
+        r.status = static_cast<std::uint8_t>(om.status(id));
+        r.qty = o.qty();
+        r.remaining = remaining;
+        r.limit = o.limitPrice().cents();
+        w.append(r);
+    });
+    w.end();
+
+    hm.saveSnapshot(w);
+
+    // 前面各段可能驻留新 symbol，Symbols 段最后写
+    w.begin(SnapshotSection::Symbols, sizeof(SnapshotString));
+    for (SymbolTable::Code c = 0; c < SymbolTable::size(); ++c) w.append(w.addString(SymbolTable::name(c)));
+    w.end();
+
+    w.header().nextOrderId = om.peekNextId();
+    w.header().nextTradeId = me.nextTradeId();
+    w.header().matchingMode = static_cast<std::uint32_t>(me.mode());
+    w.commit();
+}
+
+std::shared_ptr<const SnapshotView> Snapshot::load(const std::string& path, AccountManager& am, OrderManager& om,
+                                                   MatchingEngine& me, HistoryManager& hm) {
+    auto view = SnapshotView::open(path);
+    if (am.size() != 0 || om.size() != 0 || me.restingCount() != 0 || hm.tradeCount() != 0) {
+        throw TradeSimException(ErrorCode::InvalidState, "snapshot restore requires empty managers");
+    }
+
+    // 订单字段先整体校验（重号 / 账户不存在在暂存恢复时发现）
+    const auto orders = view->section<SnapshotOrder>(SnapshotSection::Orders);
+    if (orders.size && me.mode() != MatchingMode::Auction) {
+        throw TradeSimException(ErrorCode::InvalidState, "snapshot has resting orders but engine is not in auction mode");
+    }
+    for (const auto& r : orders) {
+        view->string(r.account);
+        view->symbol(r.symbol);
+        const bool market = r.kind == static_cast<std::uint8_t>(OrderKind::Market);
+        if (r.side > 1 || r.kind > 1 || r.status > static_cast<std::uint8_t>(OrderStatus::Rejected) ||
+            r.qty <= 0 || r.remaining <= 0 || r.remaining > r.qty || (market ? r.limit != 0 : r.limit <= 0) ||
+            r.id >= view->header().nextOrderId) {
+            throw ParseErrorException("corrupt snapshot order: " + path);
+        }
+    }
+    if (view->header().nextOrderId == 0 || view->header().nextTradeId == 0) throw ParseErrorException("corrupt snapshot counters: " + path);
+
+    // 先恢复到暂存对象，全部成功后再整体移交（移动赋值不抛异常）：任一步失败调用方的管理器保持为空
+    AccountManager stagedAm;
+    OrderManager stagedOm;
+    MatchingEngine stagedMe(me.mode());
+    HistoryManager stagedHm;
+    stagedAm.loadSnapshot(*view);
+    for (const auto& r : orders) {
+        const Symbol sym = SymbolTable::name(view->symbol(r.symbol));
+        const AccountId user(view->string(r.account));
+        if (!stagedAm.exists(user)) throw ParseErrorException("snapshot order references unknown account: " + path);
+        const auto side = static_cast<Side>(r.side);
+        auto order = r.kind == static_cast<std::uint8_t>(OrderKind::Market)
+                         ? OrderFactory::createMarketOrder(r.id, user, sym, side, r.qty)
+                         : OrderFactory::createLimitOrder(r.id, user, sym, side, r.qty, Money(r.limit));
+        try {
+            stagedOm.restore(std::move(order), static_cast<OrderStatus>(r.status));
+        } catch (const TradeSimException& e) {
+            if (e.code() != ErrorCode::Duplicate) throw;
+            throw ParseErrorException("duplicate order id in snapshot: " + path);
+        }
+        stagedMe.restoreResting(stagedOm.get(r.id), r.remaining);
+    }
+    stagedOm.restoreNextId(view->header().nextOrderId);
+    stagedMe.restoreNextTradeId(view->header().nextTradeId);
+    stagedHm.loadSnapshot(view);
+
+    am = std::move(stagedAm);
+    om = std::move(stagedOm);
+    me = std::move(stagedMe);
+    hm = std::move(stagedHm);
+    return view;
+}
+
+} // namespace trade_sim
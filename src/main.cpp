@@ -1,37 +1,152 @@
 #include "trade_sim/common/Exceptions.h"
 #include "trade_sim/core/AccountManager.h"
+#include "trade_sim/core/FlightRecorder.h"
 #include "trade_sim/core/HistoryManager.h"
 #include "trade_sim/core/MatchingEngine.h"
+#include "trade_sim/core/OrderEntryHandler.h"
 #include "trade_sim/core/OrderManager.h"
 #include "trade_sim/core/TradeExecutor.h"
-#include "trade_sim/order/OrderFactory.h"
+#include "trade_sim/io/BinaryProtocol.h"
 
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <vector>
 
 using namespace trade_sim;
 
-int main() {
-    AccountManager am;
-    OrderManager om;
-    MatchingEngine me;
-    HistoryManager hm;
-    TradeExecutor exec(am, om, me, hm);
+/**
+ * trade_sim_cli：二进制订单流驱动
+ * 用法：trade_sim_cli [--auction N] [--flight DUMP] [input|-] [output|-]
+ * - 输入：连续的 WireMessage（64 字节定长帧），默认 stdin
+ * - 输出：连续的 WireReport（执行回报），默认 stdout
+ * - --auction N：集合竞价模式，每 N 条消息及输入结束时出清一次
+ * - --flight DUMP：异常退出（含 std::terminate）时把飞行记录转储到 DUMP
+ * - 统计信息写 stderr
+ */
+namespace {
 
+constexpr std::size_t kReadBufferBytes = 1 << 20; // 每次 read 1 MiB
+constexpr std::size_t kReportBatch = 1 << 14;     // 回报攒批写出
+
+struct Options {
+    std::string input = "-";
+    std::string output = "-";
+    std::size_t auctionInterval = 0; // 0 = 连续撮合
+    std::string flightDump;          // 空 = 不转储
+};
+
+Options parseArgs(int argc, char** argv) {
+    Options opt;
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--auction" && i + 1 < argc) {
+            opt.auctionInterval = std::strtoull(argv[++i], nullptr, 10);
+            if (opt.auctionInterval == 0) throw InvalidArgumentException("--auction requires N > 0");
+        } else if (arg == "--flight" && i + 1 < argc) {
+            opt.flightDump = argv[++i];
+        } else if (positional == 0) {
+            opt.input = arg;
+            ++positional;
+        } else if (positional == 1) {
+            opt.output = arg;
+            ++positional;
+        } else {
+            throw InvalidArgumentException("usage: trade_sim_cli [--auction N] [--flight DUMP] [input|-] [output|-]");
+        }
+    }
+    return opt;
+}
+
+std::FILE* openStream(const std::string& path, const char* mode, std::FILE* fallback) {
+    if (path == "-") return fallback;
+    std::FILE* f = std::fopen(path.c_str(), mode);
+    if (!f) throw IOErrorException("cannot open file: " + path);
+    return f;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
     try {
-        am.createAccount("u1", Money(1'000'00)); // 1000.00
-        am.createAccount("u2", Money(1'000'00));
+        opt = parseArgs(argc, argv);
+        if (!opt.flightDump.empty()) FlightRecorder::installTerminateHandler(opt.flightDump);
+        std::FILE* in = openStream(opt.input, "rb", stdin);
+        std::FILE* out = openStream(opt.output, "wb", stdout);
+
+        AccountManager am;
+        OrderManager om;
+        MatchingEngine me(opt.auctionInterval ? MatchingMode::Auction : MatchingMode::Continuous);
+        HistoryManager hm;
+        TradeExecutor exec(am, om, me, hm);
+        OrderEntryHandler handler(am, om, exec);
+
+        std::vector<char> buf(kReadBufferBytes);
+        std::vector<WireReport> reports;
+        reports.reserve(kReportBatch * 2);
+
+        auto flush = [&]() {
+            if (reports.empty()) return;
+            if (std::fwrite(reports.data(), sizeof(WireReport), reports.size(), out) != reports.size()) {
+                throw IOErrorException("write execution reports failed");
+            }
+            reports.clear();
+        };
+
+        const auto t0 = std::chrono::steady_clock::now();
+        std::uint64_t messages = 0;
+        std::size_t sinceUncross = 0;
+        std::size_t have = 0;
+        try {
+            for (;;) {
+                const auto n = std::fread(buf.data() + have, 1, buf.size() - have, in);
+                if (n == 0) break;
+                have += n;
+
+                // 直接在读缓冲区上逐帧解码，不足一帧的尾部挪到缓冲区头部等下次 read
+                std::size_t off = 0;
+                for (; have - off >= sizeof(WireMessage); off += sizeof(WireMessage)) {
+                    handler.handle(decodeMessage(buf.data() + off), reports);
+                    ++messages;
+                    if (opt.auctionInterval && ++sinceUncross == opt.auctionInterval) {
+                        handler.uncrossAll(reports);
+                        sinceUncross = 0;
+                    }
+                    if (reports.size() >= kReportBatch) flush();
+                }
+                std::memmove(buf.data(), buf.data() + off, have - off);
+                have -= off;
+            }
+            if (std::ferror(in)) throw IOErrorException("read order stream failed");
+            if (have != 0) throw ParseErrorException("truncated message at end of stream");
+
+            if (opt.auctionInterval && sinceUncross) handler.uncrossAll(reports);
+        } catch (...) {
+            flush(); // 已处理消息的回报照常写出，再报告错误
+            std::fflush(out);
+            throw;
+        }
+        flush();
+        std::fflush(out);
 
-        // 演示：用 RAII 创建订单
-        auto oid = om.nextId();
-        auto order = OrderFactory::createLimitOrder(oid, "u1", "AAPL", Side::Buy, 10, Money(100'00));
-        exec.submitAndProcess(std::move(order));
+        const std::chrono::duration<double> secs = std::chrono::steady_clock::now() - t0;
+        std::cerr << "messages=" << messages << " seconds=" << secs.count()
+                  << " msg_per_sec=" << (secs.count() > 0 ? messages / secs.count() : 0.0) << "\n";
 
-        std::cout << "OK\n";
+        if (in != stdin) std::fclose(in);
+        if (out != stdout) std::fclose(out);
     } catch (const TradeSimException& e) {
         std::cerr << "[TradeSimException] code=" << static_cast<int>(e.code()) << " msg=" << e.what() << "\n";
+        FlightRecorder::dumpNoThrow(opt.flightDump);
         return 1;
     } catch (const std::exception& e) {
         std::cerr << "[std::exception] " << e.what() << "\n";
+        FlightRecorder::dumpNoThrow(opt.flightDump);
         return 1;
     }
 
@@ -0,0 +1,439 @@
+#include "trade_sim/net/OrderGateway.h"
+#include "trade_sim/common/Exceptions.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+
+namespace trade_sim {
+
+namespace {
+
+constexpr std::uint64_t kListenTag = ~std::uint64_t{0};
+constexpr std::uint64_t kWakeTag = ~std::uint64_t{0} - 1;
+constexpr std::size_t kReadChunk = 64 * 1024;
+constexpr std::size_t kMaxIov = 1024;                 // IOV_MAX
+constexpr std::size_t kMaxPendingReports = 1 << 20;   // 慢连接上限，超过即断开
+constexpr int kMaxEvents = 1024;
+
+const FrameLength kReportLength = sizeof(WireReport);
+
+[[noreturn]] void throwErrno(const std::string& what) {
+    throw IOErrorException(what + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+OrderGateway::OrderGateway(OrderEntryHandler& handler, GatewayConfig cfg)
+    : handler_(handler), cfg_(std::move(cfg)) {
+    epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) throwErrno("epoll_create1");
+    wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0) {
+        ::close(epollFd_);
+        throwErrno("eventfd");
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = kWakeTag;
+    ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+    reserveFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+    readBuf_.resize(kRequestFrameBytes + kReadChunk);
+}
+
+OrderGateway::~OrderGateway() {
+    for (auto& kv : sessions_) ::close(kv.second->fd);
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        if (!cfg_.unixPath.empty()) ::unlink(cfg_.unixPath.c_str());
+    }
+    if (reserveFd_ >= 0) ::close(reserveFd_);
+    ::close(wakeFd_);
+    ::close(epollFd_);
+}
+
+std::uint16_t OrderGateway::listen() {
+    if (listenFd_ >= 0) throw TradeSimException(ErrorCode::InvalidState, "gateway already listening");
+
+    std::uint16_t port = 0;
+    if (!cfg_.unixPath.empty()) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (cfg_.unixPath.size() >= sizeof(addr.sun_path)) throw InvalidArgumentException("unix socket path too long");
+        std::memcpy(addr.sun_path, cfg_.unixPath.c_str(), cfg_.unixPath.size() + 1);
+
+        listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd_ < 0) throwErrno("socket");
+        ::unlink(cfg_.unixPath.c_str());
+        if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) throwErrno("bind " + cfg_.unixPath);
+    } else {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(cfg_.tcpPort);
+
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd_ < 0) throwErrno("socket");
+        const int one = 1;
+        ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) throwErrno("bind 127.0.0.1");
+
+        socklen_t len = sizeof(addr);
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port = ntohs(addr.sin_port);
+    }
+    if (::listen(listenFd_, SOMAXCONN) < 0) throwErrno("listen");
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = kListenTag;
+    if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &ev) < 0) throwErrno("epoll_ctl listen");
+    return port;
+}
+
+void OrderGateway::stop() noexcept {
+    const std::uint64_t one = 1;
+    const auto n = ::write(wakeFd_, &one, sizeof(one));
+    (void)n;
+}
+
+void OrderGateway::run() {
+    if (listenFd_ < 0) throw TradeSimException(ErrorCode::InvalidState, "gateway not listening");
+
+    using Clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::milliseconds(cfg_.auctionIntervalMs);
+    auto nextUncross = Clock::now() + interval;
+
+    epoll_event events[kMaxEvents];
+    const bool syncReplication = replication_ && cfg_.replicationSyncMs > 0;
+    running_ = true;
+    while (running_) {
+        int timeout = -1;
+        if (cfg_.auctionIntervalMs > 0) {
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(nextUncross - Clock::now()).count();
+            timeout = left > 0 ? static_cast<int>(left) : 0;
+        }
+
+        const int n = ::epoll_wait(epollFd_, events, kMaxEvents, timeout);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throwErrno("epoll_wait");
+        }
+
+        // 1) 读 + 处理所有就绪连接，回报先进入各连接的 out 队列
+        for (int i = 0; i < n; ++i) {
+            const auto tag = events[i].data.u64;
+            if (tag == kListenTag) {
+                acceptAll();
+                continue;
+            }
+            if (tag == kWakeTag) {
+                std::uint64_t v = 0;
+                const auto r = ::read(wakeFd_, &v, sizeof(v));
+                (void)r;
+                running_ = false;
+                continue;
+            }
+            auto it = sessions_.find(tag);
+            if (it == sessions_.end()) continue; // 本轮已关闭
+            Session& s = *it->second;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                onReadable(s);
+                if (sessions_.find(tag) == sessions_.end()) continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                // 同步复制：本轮新回报须等确认后再发，可写事件也推迟到第 3 步
+                if (syncReplication) {
+                    markDirty(s);
+                } else {
+                    flush(s);
+                }
+            }
+        }
+
+        // 2) 定时集合竞价出清
+        if (cfg_.auctionIntervalMs > 0 && Clock::now() >= nextUncross) {
+            if (replication_) replication_->publishUncross();
+            handler_.uncrossAll(scratch_);
+            route(nullptr);
+            nextUncross = Clock::now() + interval;
+        }
+
+        // 3) 本轮输入交给复制线程（同步复制时等待确认），再按连接批量回写
+        if (replication_) {
+            replication_->flush();
+            if (syncReplication && replication_->healthy() &&
+                !replication_->waitAcked(replication_->publishedSeq(), cfg_.replicationSyncMs)) {
+                ++replicationSyncTimeouts_;
+            }
+        }
+        for (auto id : dirty_) {
+            auto it = sessions_.find(id);
+            if (it != sessions_.end()) flush(*it->second);
+        }
+        dirty_.clear();
+    }
+}
+
+void OrderGateway::acceptAll() {
+    for (;;) {
+        const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            // fd 用尽：不接受则监听 fd 一直可读（水平触发）使事件循环空转，腾出预留 fd 接受后立即关闭
+            if ((errno == EMFILE || errno == ENFILE) && dropOneConnection()) continue;
+            return; // EAGAIN 等：留给下一轮
+        }
+        if (cfg_.unixPath.empty()) {
+            const int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+
+        auto s = std::make_unique<Session>();
+        s->fd = fd;
+        s->id = nextSessionId_++;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = s->id;
+        if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            ::close(fd);
+            continue;
+        }
+        sessions_.emplace(s->id, std::move(s));
+    }
+}
+
+bool OrderGateway::dropOneConnection() {
+    if (reserveFd_ < 0) return false;
+    ::close(reserveFd_);
+    const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd >= 0) {
+        ::close(fd);
+        ++droppedConnections_;
+    }
+    reserveFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+    return fd >= 0;
+}
+
+void OrderGateway::onReadable(Session& s) {
+    // 每个事件只 read 一次（水平触发，剩余数据下一轮继续），避免单个连接独占事件循环；
+    // 读进共用缓冲，半帧先拷到缓冲开头，解析完把新的半帧存回 Session
+    char* buf = readBuf_.data();
+    std::memcpy(buf, s.partial, s.partialLen);
+    const auto n = ::read(s.fd, buf + s.partialLen, kReadChunk);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+        close(s.id);
+        return;
+    }
+    if (n < 0) return;
+    const std::size_t len = s.partialLen + static_cast<std::size_t>(n);
+
+    std::size_t off = 0;
+    while (len - off >= sizeof(FrameLength)) {
+        FrameLength frameLen = 0;
+        std::memcpy(&frameLen, buf + off, sizeof(frameLen));
+        if (frameLen != sizeof(WireMessage)) {
+            close(s.id); // 协议错误
+            return;
+        }
+        if (len - off < kRequestFrameBytes) break;
+        const WireMessage msg = decodeMessage(buf + off + sizeof(FrameLength));
+        off += kRequestFrameBytes;
+        if (!ownsTarget(s, msg)) {
+            // 不是本连接下的订单：就地拒绝，不进入业务处理，也不复制
+            WireReport r;
+            r.type = static_cast<std::uint8_t>(ReportType::Rejected);
+            r.error = static_cast<std::uint8_t>(ErrorCode::NotFound);
+            r.clientSeq = msg.clientSeq;
+            r.orderId = msg.orderId;
+            r.qty = msg.qty;
+            r.price = msg.amount;
+            deliver(s.id, r);
+            continue;
+        }
+        if (replication_) replication_->publish(msg);
+        handler_.handle(msg, scratch_);
+        route(&s);
+    }
+    s.partialLen = len - off; // < kRequestFrameBytes
+    std::memcpy(s.partial, buf + off, s.partialLen);
+}
+
+void OrderGateway::route(Session* origin) {
+    for (const auto& r : scratch_) {
+        switch (static_cast<ReportType>(r.type)) {
+        case ReportType::Trade: {
+            const auto buyIt = owners_.find(r.orderId);
+            const auto sellIt = owners_.find(r.contraId);
+            if (buyIt != owners_.end()) deliver(buyIt->second, r);
+            if (sellIt != owners_.end() && (buyIt == owners_.end() || sellIt->second != buyIt->second)) {
+                deliver(sellIt->second, r);
+            }
+            if (r.error & kTradeBuyFilled) release(r.orderId);
+            if (r.error & kTradeSellFilled) release(r.contraId);
+            break;
+        }
+        case ReportType::Accepted:
+            if (origin) {
+                adopt(*origin, r.orderId);
+                deliver(origin->id, r);
+            }
+            break;
+        case ReportType::Cancelled:
+        case ReportType::Amended: {
+            // 送往订单所属连接（ownsTarget 已保证即请求方）
+            const auto it = owners_.find(r.orderId);
+            if (it != owners_.end()) {
+                deliver(it->second, r);
+            } else if (origin) {
+                deliver(origin->id, r);
+            }
+            if (r.type == static_cast<std::uint8_t>(ReportType::Cancelled)) release(r.orderId);
+            break;
+        }
+        case ReportType::Rejected: {
+            if (origin) {
+                deliver(origin->id, r);
+                break;
+            }
+            // 出清结算拒单：订单已移出簿，回报送往订单所属连接
+            ++settlementRejects_;
+            const auto it = owners_.find(r.orderId);
+            if (it != owners_.end()) deliver(it->second, r);
+            release(r.orderId);
+            break;
+        }
+        default:
+            if (origin) deliver(origin->id, r);
+            break;
+        }
+    }
+    scratch_.clear();
+}
+
+bool OrderGateway::ownsTarget(const Session& s, const WireMessage& msg) const {
+    const auto type = static_cast<MsgType>(msg.type);
+    if (type != MsgType::Cancel && type != MsgType::Amend) return true;
+    const auto it = owners_.find(msg.orderId);
+    return it != owners_.end() && it->second == s.id;
+}
+
+void OrderGateway::deliver(std::uint64_t sessionId, const WireReport& r) {
+    auto it = sessions_.find(sessionId);
+    if (it == sessions_.end()) return;
+    Session& s = *it->second;
+    s.out.push_back(r);
+    markDirty(s);
+}
+
+void OrderGateway::markDirty(Session& s) {
+    if (s.dirty) return;
+    s.dirty = true;
+    dirty_.push_back(s.id);
+}
+
+void OrderGateway::adopt(Session& s, OrderId id) {
+    owners_[id] = s.id;
+    s.orders.push_back(id);
+    ++s.liveOrders;
+    if (s.orders.size() > 2 * s.liveOrders + 64) {
+        // 压缩：只留仍归本连接的订单
+        std::size_t keep = 0;
+        for (const auto oid : s.orders) {
+            const auto it = owners_.find(oid);
+            if (it != owners_.end() && it->second == s.id) s.orders[keep++] = oid;
+        }
+        s.orders.resize(keep);
+    }
+}
+
+void OrderGateway::release(OrderId id) {
+    const auto it = owners_.find(id);
+    if (it == owners_.end()) return;
+    const auto s = sessions_.find(it->second);
+    if (s != sessions_.end()) --s->second->liveOrders;
+    owners_.erase(it);
+}
+
+void OrderGateway::flush(Session& s) {
+    s.dirty = false;
+    if (s.out.size() > kMaxPendingReports) {
+        close(s.id);
+        return;
+    }
+
+    // 帧流 = [len][report][len][report]...；len 都指向同一个常量，回报直接从 out 发送，无拷贝
+    const std::size_t total = s.out.size() * kReportFrameBytes;
+    while (s.sentBytes < total) {
+        iovec iov[kMaxIov];
+        std::size_t cnt = 0;
+        std::size_t frame = s.sentBytes / kReportFrameBytes;
+        std::size_t off = s.sentBytes % kReportFrameBytes;
+        for (; frame < s.out.size() && cnt + 2 <= kMaxIov; ++frame, off = 0) {
+            auto* body = reinterpret_cast<char*>(&s.out[frame]);
+            if (off < sizeof(FrameLength)) {
+                iov[cnt].iov_base = const_cast<char*>(reinterpret_cast<const char*>(&kReportLength)) + off;
+                iov[cnt++].iov_len = sizeof(FrameLength) - off;
+                iov[cnt].iov_base = body;
+                iov[cnt++].iov_len = sizeof(WireReport);
+            } else {
+                const auto skip = off - sizeof(FrameLength);
+                iov[cnt].iov_base = body + skip;
+                iov[cnt++].iov_len = sizeof(WireReport) - skip;
+            }
+        }
+
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = cnt;
+        const auto n = ::sendmsg(s.fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                updateInterest(s, true);
+                return;
+            }
+            close(s.id);
+            return;
+        }
+        s.sentBytes += static_cast<std::size_t>(n);
+    }
+
+    s.out.clear();
+    s.sentBytes = 0;
+    if (s.wantWrite) updateInterest(s, false);
+}
+
+void OrderGateway::updateInterest(Session& s, bool wantWrite) {
+    if (s.wantWrite == wantWrite) return;
+    epoll_event ev{};
+    ev.events = EPOLLIN | (wantWrite ? EPOLLOUT : 0u);
+    ev.data.u64 = s.id;
+    ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, s.fd, &ev);
+    s.wantWrite = wantWrite;
+}
+
+void OrderGateway::close(std::uint64_t sessionId) {
+    auto it = sessions_.find(sessionId);
+    if (it == sessions_.end()) return;
+    for (const auto id : it->second->orders) {
+        const auto owner = owners_.find(id);
+        if (owner != owners_.end() && owner->second == sessionId) owners_.erase(owner);
+    }
+    ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, it->second->fd, nullptr);
+    ::close(it->second->fd);
+    sessions_.erase(it);
+}
+
+} // namespace trade_sim
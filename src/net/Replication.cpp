@@ -0,0 +1,376 @@
+#include "trade_sim/net/Replication.h"
+#include "trade_sim/common/Exceptions.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+
+namespace trade_sim {
+
+namespace {
+
+constexpr std::size_t kReadChunk = 64 * 1024;
+constexpr int kCloseAckTimeoutMs = 1000; // close 时等待最后确认的上限
+
+[[noreturn]] void throwErrno(const std::string& what) {
+    throw IOErrorException(what + ": " + std::strerror(errno));
+}
+
+/** 异常路径上也要关闭连接 */
+struct FdGuard {
+    int fd{-1};
+    ~FdGuard() {
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+bool sendAll(int fd, const void* data, std::size_t bytes) {
+    const auto* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+        const auto n = ::send(fd, p, bytes, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        bytes -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+void setNoDelay(int fd) {
+    const int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+sockaddr_un unixAddress(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) throw InvalidArgumentException("unix socket path too long");
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return addr;
+}
+
+sockaddr_in loopbackAddress(std::uint16_t port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    return addr;
+}
+
+} // namespace
+
+// ---------------- ReplicationPublisher ----------------
+
+ReplicationPublisher::ReplicationPublisher(ReplicationConfig cfg) : cfg_(std::move(cfg)) {}
+
+ReplicationPublisher::~ReplicationPublisher() {
+    close();
+}
+
+void ReplicationPublisher::connect() {
+    if (fd_ >= 0) throw TradeSimException(ErrorCode::InvalidState, "replication already connected");
+
+    FdGuard guard;
+    if (!cfg_.unixPath.empty()) {
+        const auto addr = unixAddress(cfg_.unixPath);
+        guard.fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (guard.fd < 0) throwErrno("socket");
+        if (::connect(guard.fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+            throwErrno("connect " + cfg_.unixPath);
+        }
+    } else {
+        const auto addr = loopbackAddress(cfg_.tcpPort);
+        guard.fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (guard.fd < 0) throwErrno("socket");
+        if (::connect(guard.fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+            throwErrno("connect 127.0.0.1");
+        }
+        setNoDelay(guard.fd);
+    }
+
+    ReplicationHello hello;
+    std::memcpy(hello.magic, kReplicationMagic, sizeof(kReplicationMagic));
+    hello.version = kReplicationVersion;
+    hello.recordSize = sizeof(ReplicationRecord);
+    hello.firstSeq = seq_ + 1;
+    if (!sendAll(guard.fd, &hello, sizeof(hello))) throwErrno("send replication hello");
+
+    fd_ = guard.fd;
+    guard.fd = -1;
+    healthy_.store(true, std::memory_order_release);
+    sender_ = std::thread(&ReplicationPublisher::sendLoop, this);
+    acker_ = std::thread(&ReplicationPublisher::ackLoop, this);
+}
+
+void ReplicationPublisher::flush() {
+    if (batch_.empty()) return;
+    if (!healthy()) {
+        batch_.clear();
+        return;
+    }
+
+    bool wake = false;
+    bool overflow = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queued_.size() + batch_.size() > cfg_.maxPendingRecords) {
+            overflow = true;
+        } else if (queued_.empty()) {
+            queued_.swap(batch_); // 常见情形：发送线程已追上，整批换过去，不拷贝
+        } else {
+            queued_.insert(queued_.end(), batch_.begin(), batch_.end());
+        }
+        wake = senderWaiting_;
+    }
+    batch_.clear();
+    if (overflow) {
+        fail(); // 备节点跟不上：放弃复制，主节点不被拖慢
+        return;
+    }
+    if (wake) cv_.notify_one();
+}
+
+bool ReplicationPublisher::waitAcked(std::uint64_t seq, int timeoutMs) {
+    std::unique_lock<std::mutex> lock(ackMutex_);
+    ackCv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] { return ackedSeq() >= seq || !healthy(); });
+    return ackedSeq() >= seq;
+}
+
+void ReplicationPublisher::close() {
+    if (fd_ < 0) return;
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closing_ = true;
+    }
+    cv_.notify_all();
+    if (sender_.joinable()) sender_.join();
+
+    // 写端已关闭；尽量收完最后的确认再断开，避免未读数据触发 RST
+    waitAcked(seq_, kCloseAckTimeoutMs);
+    ::shutdown(fd_, SHUT_RDWR);
+    if (acker_.joinable()) acker_.join();
+    ::close(fd_);
+    fd_ = -1;
+    healthy_.store(false, std::memory_order_release);
+}
+
+void ReplicationPublisher::sendLoop() {
+    std::vector<ReplicationRecord> sending;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (queued_.empty() && !closing_ && healthy()) {
+                senderWaiting_ = true;
+                cv_.wait(lock);
+                senderWaiting_ = false;
+            }
+            if (queued_.empty() || !healthy()) break;
+            sending.swap(queued_);
+        }
+        // 一批一次 send：批内记录连续存放，直接作为字节流发出
+        if (!sendAll(fd_, sending.data(), sending.size() * sizeof(ReplicationRecord))) {
+            fail();
+            break;
+        }
+        sending.clear();
+    }
+    if (healthy()) ::shutdown(fd_, SHUT_WR);
+}
+
+void ReplicationPublisher::ackLoop() {
+    std::uint64_t ack = 0;
+    std::size_t got = 0;
+    for (;;) {
+        const auto n = ::recv(fd_, reinterpret_cast<char*>(&ack) + got, sizeof(ack) - got, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        got += static_cast<std::size_t>(n);
+        if (got < sizeof(ack)) continue;
+        got = 0;
+        {
+            std::lock_guard<std::mutex> lock(ackMutex_);
+            acked_.store(ack, std::memory_order_release);
+        }
+        ackCv_.notify_all();
+    }
+    fail();
+}
+
+void ReplicationPublisher::fail() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!healthy()) return;
+        healthy_.store(false, std::memory_order_release);
+    }
+    ::shutdown(fd_, SHUT_RDWR); // 唤醒阻塞在 send / recv 上的线程
+    cv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(ackMutex_);
+    }
+    ackCv_.notify_all();
+}
+
+// ---------------- ReplicationStandby ----------------
+
+ReplicationStandby::ReplicationStandby(OrderEntryHandler& handler, ReplicationConfig cfg)
+    : handler_(handler), cfg_(std::move(cfg)) {
+    wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0) throwErrno("eventfd");
+}
+
+ReplicationStandby::~ReplicationStandby() {
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        if (!cfg_.unixPath.empty()) ::unlink(cfg_.unixPath.c_str());
+    }
+    ::close(wakeFd_);
+}
+
+std::uint16_t ReplicationStandby::listen() {
+    if (listenFd_ >= 0) throw TradeSimException(ErrorCode::InvalidState, "standby already listening");
+
+    std::uint16_t port = 0;
+    if (!cfg_.unixPath.empty()) {
+        const auto addr = unixAddress(cfg_.unixPath);
+        listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd_ < 0) throwErrno("socket");
+        ::unlink(cfg_.unixPath.c_str());
+        if (::bind(listenFd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+            throwErrno("bind " + cfg_.unixPath);
+        }
+    } else {
+        auto addr = loopbackAddress(cfg_.tcpPort);
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd_ < 0) throwErrno("socket");
+        const int one = 1;
+        ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (::bind(listenFd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+            throwErrno("bind 127.0.0.1");
+        }
+        socklen_t len = sizeof(addr);
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port = ntohs(addr.sin_port);
+    }
+    if (::listen(listenFd_, 1) < 0) throwErrno("listen");
+    return port;
+}
+
+void ReplicationStandby::stop() noexcept {
+    const std::uint64_t one = 1;
+    const auto n = ::write(wakeFd_, &one, sizeof(one));
+    (void)n;
+}
+
+bool ReplicationStandby::run() {
+    if (listenFd_ < 0) throw TradeSimException(ErrorCode::InvalidState, "standby not listening");
+
+    // 等待 fd 可读；被 stop() 唤醒返回 false
+    auto waitReadable = [this](int fd) {
+        for (;;) {
+            pollfd p[2] = {{fd, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+            if (::poll(p, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                throwErrno("poll");
+            }
+            if (p[1].revents) {
+                std::uint64_t v = 0;
+                const auto r = ::read(wakeFd_, &v, sizeof(v));
+                (void)r;
+                return false;
+            }
+            return true;
+        }
+    };
+
+    // 1) 接受主节点
+    FdGuard conn;
+    while (conn.fd < 0) {
+        if (!waitReadable(listenFd_)) return false;
+        conn.fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (conn.fd < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) throwErrno("accept");
+    }
+    if (cfg_.unixPath.empty()) setNoDelay(conn.fd);
+    haveHello_ = false;
+
+    // 2) 按序应用，每读一批回一次累计确认
+    std::vector<char> in(kReadChunk);
+    std::size_t inLen = 0;
+    for (;;) {
+        if (!waitReadable(conn.fd)) return false;
+        const auto n = ::read(conn.fd, in.data() + inLen, in.size() - inLen);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return true; // 主节点断开：由调用方接管
+
+        inLen += static_cast<std::size_t>(n);
+        const auto used = apply(in.data(), inLen);
+        std::memmove(in.data(), in.data() + used, inLen - used);
+        inLen -= used;
+
+        const std::uint64_t ack = appliedSeq();
+        if (used > 0 && !sendAll(conn.fd, &ack, sizeof(ack))) return true;
+    }
+}
+
+std::size_t ReplicationStandby::apply(const char* data, std::size_t len) {
+    std::size_t off = 0;
+    auto seq = applied_.load(std::memory_order_relaxed);
+    if (!haveHello_) {
+        if (len < sizeof(ReplicationHello)) return 0;
+        ReplicationHello hello;
+        std::memcpy(&hello, data, sizeof(hello));
+        if (std::memcmp(hello.magic, kReplicationMagic, sizeof(kReplicationMagic)) != 0) {
+            throw ParseErrorException("not a replication stream");
+        }
+        if (hello.version != kReplicationVersion || hello.recordSize != sizeof(ReplicationRecord)) {
+            throw ParseErrorException("unsupported replication version");
+        }
+        if (hello.firstSeq != seq + 1) {
+            throw ParseErrorException("replication stream starts at seq " + std::to_string(hello.firstSeq) +
+                                      ", standby expects " + std::to_string(seq + 1));
+        }
+        haveHello_ = true;
+        off = sizeof(hello);
+    }
+
+    while (len - off >= sizeof(ReplicationRecord)) {
+        ReplicationRecord r;
+        std::memcpy(&r, data + off, sizeof(r));
+        if (r.seq != seq + 1) {
+            throw ParseErrorException("replication gap: got seq " + std::to_string(r.seq) + ", expected " +
+                                      std::to_string(seq + 1));
+        }
+        switch (static_cast<ReplicationKind>(r.kind)) {
+        case ReplicationKind::Message:
+            handler_.handle(r.msg, scratch_);
+            break;
+        case ReplicationKind::Uncross:
+            // 与网关同一段逻辑：结算失败的订单以 Rejected 回报给出，回报丢弃，只计数
+            handler_.uncrossAll(scratch_);
+            for (const auto& rep : scratch_) {
+                if (rep.type == static_cast<std::uint8_t>(ReportType::Rejected)) ++settlementRejects_;
+            }
+            break;
+        default:
+            throw ParseErrorException("unknown replication record kind " + std::to_string(r.kind));
+        }
+        scratch_.clear();
+        seq = r.seq;
+        off += sizeof(r);
+    }
+    applied_.store(seq, std::memory_order_release);
+    return off;
+}
+
+} // namespace trade_sim
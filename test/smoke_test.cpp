@@ -1,13 +1,41 @@
 #include "trade_sim/common/Exceptions.h"
 #include "trade_sim/core/AccountManager.h"
+#include "trade_sim/core/FlightRecorder.h"
 #include "trade_sim/core/HistoryManager.h"
 #include "trade_sim/core/MatchingEngine.h"
+#include "trade_sim/core/OrderEntryHandler.h"
 #include "trade_sim/core/OrderManager.h"
 #include "trade_sim/core/TradeExecutor.h"
+#include "trade_sim/core/ValuationEngine.h"
+#include "trade_sim/io/BinaryProtocol.h"
+#include "trade_sim/io/Snapshot.h"
+#include "trade_sim/io/Storage.h"
 #include "trade_sim/order/OrderFactory.h"
 #include "trade_sim/order/Orders.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifdef TRADE_SIM_HAS_NET
+#include "trade_sim/net/OrderGateway.h"
+#include "trade_sim/net/Replication.h"
+
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#endif
 
 using namespace trade_sim;
 
@@ -98,5 +126,1056 @@ int main() {
     assert(omExec.status(pendingId) == OrderStatus::Pending);
     assert(hmExec.historyOf("buyer").empty());
 
+    // 9) MatchingEngine auction: 单一出清价，最大成交量，未成交部分留簿
+    MatchingEngine auction(MatchingMode::Auction);
+    LimitOrder ab1(101, "b", "AAPL", Side::Buy, 5, Money(100));
+    LimitOrder ab2(102, "b", "AAPL", Side::Buy, 5, Money(102));
+    LimitOrder as1(103, "s", "AAPL", Side::Sell, 4, Money(100));
+    LimitOrder as2(104, "s", "AAPL", Side::Sell, 4, Money(101));
+    const auto acc1 = auction.match(ab1);
+    const auto acc2 = auction.match(ab2);
+    const auto acc3 = auction.match(as1);
+    const auto acc4 = auction.match(as2);
+    assert(acc1.empty() && acc2.empty() && acc3.empty() && acc4.empty());
+    assert(auction.pendingCount("AAPL") == 4);
+
+    auto crossed = auction.uncross("AAPL");
+    assert(crossed.size() == 2);
+    assert(crossed[0].buyOrderId == 102 && crossed[0].sellOrderId == 103 && crossed[0].qty == 4);
+    assert(crossed[1].buyOrderId == 102 && crossed[1].sellOrderId == 104 && crossed[1].qty == 1);
+    assert(crossed[0].price == Money(101) && crossed[1].price == Money(101));
+    assert(auction.pendingCount("AAPL") == 2);
+    const auto recrossed = auction.uncross("AAPL");
+    assert(recrossed.empty());
+
+    // 10) MatchingEngine continuous: uncross -> InvalidState
+    thrown = false;
+    try {
+        (void)me.uncross("AAPL");
+    } catch (const TradeSimException& e) {
+        thrown = e.code() == ErrorCode::InvalidState;
+    }
+    assert(thrown);
+
+    // 11) TradeExecutor auction: 出清成交走同一结算 + 历史流程
+    AccountManager amAuc;
+    OrderManager omAuc;
+    MatchingEngine meAuc(MatchingMode::Auction);
+    HistoryManager hmAuc;
+    TradeExecutor execAuc(amAuc, omAuc, meAuc, hmAuc);
+    amAuc.createAccount("buyer", Money(10000));
+    amAuc.createAccount("seller", Money(0));
+    amAuc.getAccount("seller").addPosition("AAPL", 10);
+
+    const auto aucSell = omAuc.nextId();
+    execAuc.submitAndProcess(OrderFactory::createLimitOrder(aucSell, "seller", "AAPL", Side::Sell, 10, Money(90)));
+    const auto aucBuy = omAuc.nextId();
+    execAuc.submitAndProcess(OrderFactory::createMarketOrder(aucBuy, "buyer", "AAPL", Side::Buy, 6));
+    assert(hmAuc.historyOf("buyer").empty());
+
+    execAuc.uncrossAndProcess("AAPL");
+    assert(amAuc.getAccount("buyer").positionOf("AAPL") == 6);
+    assert(amAuc.getAccount("buyer").balance() == Money(10000 - 6 * 90));
+    assert(amAuc.getAccount("seller").positionOf("AAPL") == 4);
+    assert(amAuc.getAccount("seller").balance() == Money(6 * 90));
+    assert(hmAuc.historyOf("buyer").size() == 1);
+    assert(hmAuc.historyOf("seller").size() == 1);
+    assert(meAuc.pendingCount("AAPL") == 1);
+    assert(omAuc.status(aucBuy) == OrderStatus::Filled && omAuc.status(aucSell) == OrderStatus::PartiallyFilled);
+
+    // 11b) 出清逐笔结算：无法结算的订单整单拒绝并移出簿，对手方留簿继续分配，其余成交照常结算
+    amAuc.createAccount("broke", Money(0));
+    amAuc.createAccount("naked", Money(0));
+    amAuc.createAccount("rich", Money(100000));
+    amAuc.getAccount("seller").addPosition("MSFT", 20);
+    const auto brokeBuy = omAuc.nextId();
+    execAuc.submitAndProcess(OrderFactory::createLimitOrder(brokeBuy, "broke", "MSFT", Side::Buy, 10, Money(100)));
+    const auto richBuy = omAuc.nextId();
+    execAuc.submitAndProcess(OrderFactory::createLimitOrder(richBuy, "rich", "MSFT", Side::Buy, 10, Money(100)));
+    const auto nakedSell = omAuc.nextId();
+    execAuc.submitAndProcess(OrderFactory::createLimitOrder(nakedSell, "naked", "MSFT", Side::Sell, 5, Money(95)));
+    const auto fullSell = omAuc.nextId();
+    execAuc.submitAndProcess(OrderFactory::createLimitOrder(fullSell, "seller", "MSFT", Side::Sell, 20, Money(100)));
+
+    std::vector<SettlementReject> aucRejects;
+    const auto partial = execAuc.uncrossAndProcess("MSFT", &aucRejects);
+    assert(partial.size() == 1 && partial[0].buyOrderId == richBuy && partial[0].sellOrderId == fullSell);
+    assert(partial[0].qty == 10 && partial[0].price == Money(100));
+    assert(aucRejects.size() == 2);
+    assert(aucRejects[0].orderId == brokeBuy && aucRejects[0].code == ErrorCode::InsufficientFunds);
+    assert(aucRejects[1].orderId == nakedSell && aucRejects[1].code == ErrorCode::InsufficientPosition);
+    assert(omAuc.status(brokeBuy) == OrderStatus::Rejected && omAuc.status(nakedSell) == OrderStatus::Rejected);
+    assert(amAuc.getAccount("rich").positionOf("MSFT") == 10);
+    assert(amAuc.getAccount("seller").positionOf("MSFT") == 10);
+    assert(meAuc.pendingCount("MSFT") == 1); // 卖单剩 10 留簿
+    const auto afterReject = execAuc.uncrossAndProcess("MSFT");
+    assert(afterReject.empty());
+
+    // 12) BinaryProtocol: 定长帧编解码往返
+    WireMessage wm;
+    wm.type = static_cast<std::uint8_t>(MsgType::NewOrder);
+    wm.clientSeq = 7;
+    wm.qty = 3;
+    setWireString(wm.account, "client-0000001");
+    setWireString(wm.symbol, "AAPL");
+    char frame[sizeof(WireMessage)];
+    encodeMessage(wm, frame);
+    const WireMessage back = decodeMessage(frame);
+    assert(back.clientSeq == 7 && back.qty == 3);
+    assert(wireString(back.account) == "client-0000001");
+    assert(wireString(back.symbol) == "AAPL");
+    thrown = false;
+    try {
+        setWireString(wm.symbol, "TOO_LONG_SYMBOL");
+    } catch (const InvalidArgumentException&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // 13) OrderEntryHandler: 入金开户 / 下单 / 撤单 / 出清 / 拒单
+    AccountManager amWire;
+    OrderManager omWire;
+    MatchingEngine meWire(MatchingMode::Auction);
+    HistoryManager hmWire;
+    TradeExecutor execWire(amWire, omWire, meWire, hmWire);
+    OrderEntryHandler handler(amWire, omWire, execWire);
+    std::vector<WireReport> reports;
+
+    WireMessage dep;
+    dep.type = static_cast<std::uint8_t>(MsgType::Deposit);
+    dep.clientSeq = 1;
+    dep.amount = 5000;
+    setWireString(dep.account, "w1");
+    handler.handle(dep, reports);
+    handler.handle(dep, reports);
+    assert(reports.size() == 2);
+    assert(reports[1].type == static_cast<std::uint8_t>(ReportType::Deposited) && reports[1].price == 10000);
+    amWire.createAccount("w2", Money(0));
+    amWire.getAccount("w2").addPosition("AAPL", 5);
+
+    WireMessage buy;
+    buy.type = static_cast<std::uint8_t>(MsgType::NewOrder);
+    buy.clientSeq = 2;
+    buy.side = 0;
+    buy.kind = 1;
+    buy.qty = 5;
+    buy.amount = 100;
+    setWireString(buy.account, "w1");
+    setWireString(buy.symbol, "AAPL");
+    WireMessage sell = buy;
+    sell.clientSeq = 3;
+    sell.side = 1;
+    setWireString(sell.account, "w2");
+    WireMessage stale = buy;
+    stale.clientSeq = 4;
+
+    reports.clear();
+    handler.handle(buy, reports);
+    handler.handle(stale, reports);
+    assert(reports.size() == 2 && reports[0].type == static_cast<std::uint8_t>(ReportType::Accepted));
+    const auto staleId = reports[1].orderId;
+
+    WireMessage cxl;
+    cxl.type = static_cast<std::uint8_t>(MsgType::Cancel);
+    cxl.clientSeq = 5;
+    cxl.orderId = staleId;
+    setWireString(cxl.account, "w2"); // 不是订单所属账户：按不存在拒绝
+    handler.handle(cxl, reports);
+    assert(reports.back().type == static_cast<std::uint8_t>(ReportType::Rejected));
+    assert(reports.back().error == static_cast<std::uint8_t>(ErrorCode::NotFound));
+    assert(omWire.status(staleId) == OrderStatus::Pending);
+    setWireString(cxl.account, "w1");
+    handler.handle(cxl, reports);
+    assert(reports.back().type == static_cast<std::uint8_t>(ReportType::Cancelled));
+    assert(omWire.status(staleId) == OrderStatus::Cancelled);
+    handler.handle(sell, reports);
+    assert(meWire.pendingCount("AAPL") == 2);
+
+    reports.clear();
+    handler.uncrossAll(reports);
+    assert(reports.size() == 1 && reports[0].type == static_cast<std::uint8_t>(ReportType::Trade));
+    assert(reports[0].qty == 5 && reports[0].price == 100);
+    assert(reports[0].error == (kTradeBuyFilled | kTradeSellFilled));
+    assert(amWire.getAccount("w1").positionOf("AAPL") == 5);
+
+    // 出清结算失败：责任方订单以 Rejected 回报（clientSeq = 0），对手方留簿；Deposit 可存入持仓
+    WireMessage depPos = dep;
+    depPos.amount = 0;
+    depPos.qty = 7;
+    setWireString(depPos.account, "w3");
+    setWireString(depPos.symbol, "AAPL");
+    WireMessage depCash = dep;
+    depCash.amount = 0;
+    setWireString(depCash.account, "w4");
+    WireMessage brokeBid = buy;
+    setWireString(brokeBid.account, "w4");
+    WireMessage posAsk = sell;
+    posAsk.qty = 7;
+    setWireString(posAsk.account, "w3");
+    reports.clear();
+    handler.handle(depPos, reports);
+    handler.handle(depCash, reports);
+    handler.handle(brokeBid, reports);
+    handler.handle(posAsk, reports);
+    assert(amWire.getAccount("w3").positionOf("AAPL") == 7);
+    const auto brokeId = reports[2].orderId;
+    reports.clear();
+    handler.uncrossAll(reports);
+    assert(reports.size() == 1 && reports[0].type == static_cast<std::uint8_t>(ReportType::Rejected));
+    assert(reports[0].orderId == brokeId && reports[0].clientSeq == 0);
+    assert(reports[0].error == static_cast<std::uint8_t>(ErrorCode::InsufficientFunds));
+    assert(meWire.pendingCount("AAPL") == 1);
+
+    WireMessage bad = buy;
+    bad.clientSeq = 6;
+    bad.qty = 0;
+    reports.clear();
+    handler.handle(bad, reports);
+    assert(reports.size() == 1 && reports[0].type == static_cast<std::uint8_t>(ReportType::Rejected));
+    assert(reports[0].error == static_cast<std::uint8_t>(ErrorCode::InvalidArgument));
+    assert(reports[0].clientSeq == 6);
+
+    // 15) ValuationEngine: 平均成本 / 已实现 / 未实现 / 敞口，增量与全量重估一致
+    ValuationEngine ve;
+    ve.onPrice("AAPL", Money(100));
+    ve.applyFill("v1", "AAPL", 10, Money(90));
+    auto val = ve.valuationOf("v1");
+    assert(val.marketValue == Money(1000) && val.unrealizedPnl == Money(100) && val.grossExposure == Money(1000));
+    ve.applyFill("v1", "AAPL", -4, Money(110));
+    val = ve.valuationOf("v1");
+    assert(val.realizedPnl == Money(80) && val.marketValue == Money(600) && val.unrealizedPnl == Money(60));
+    ve.onPrice("AAPL", Money(120));
+    val = ve.valuationOf("v1");
+    assert(val.marketValue == Money(720) && val.unrealizedPnl == Money(180) && val.grossExposure == Money(720));
+    ve.revalueAll();
+    const auto full = ve.valuationOf("v1");
+    assert(full.marketValue == val.marketValue && full.grossExposure == val.grossExposure);
+    // 空头：超卖部分按成交价计成本；买回按平均成本结转，穿越 0 的余量开多头
+    ve.applyFill("v2", "AAPL", -10, Money(100));
+    val = ve.valuationOf("v2");
+    assert(val.realizedPnl == Money(0) && val.marketValue == Money(-1200) && val.unrealizedPnl == Money(-200));
+    assert(val.grossExposure == Money(1200));
+    ve.applyFill("v2", "AAPL", 4, Money(110));
+    assert(ve.valuationOf("v2").realizedPnl == Money(-40));
+    ve.applyFill("v2", "AAPL", 10, Money(90));
+    val = ve.valuationOf("v2");
+    assert(val.realizedPnl == Money(20) && val.marketValue == Money(480) && val.unrealizedPnl == Money(120));
+    thrown = false;
+    try {
+        (void)ve.valuationOf("nobody");
+    } catch (const NotFoundException&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // 16) TradeExecutor + ValuationEngine: 挂接时按标记价导入已有持仓，结算后增量更新买卖双方；持仓归零即移出持有人
+    ValuationEngine veExec;
+    veExec.onPrice("AAPL", Money(80));
+    const auto buyerHeld = amAuc.getAccount("buyer").positionOf("AAPL");
+    assert(buyerHeld > 0 && amAuc.getAccount("seller").positionOf("AAPL") == 4);
+    execAuc.attachValuation(&veExec);
+    assert(veExec.valuationOf("seller").marketValue == Money(4 * 80));
+    assert(veExec.valuationOf("seller").unrealizedPnl == Money(0) && veExec.holderCount("AAPL") == 2);
+    execAuc.submitAndProcess(OrderFactory::createMarketOrder(omAuc.nextId(), "buyer", "AAPL", Side::Buy, 4));
+    execAuc.uncrossAndProcess("AAPL");
+    assert(veExec.valuationOf("seller").realizedPnl == Money(4 * 10)); // 导入成本 80，卖出 90：不再记为空头
+    assert(veExec.valuationOf("seller").marketValue == Money(0) && veExec.holderCount("AAPL") == 1);
+    assert(veExec.valuationOf("buyer").unrealizedPnl == Money(-4 * 10));
+    veExec.onPrice("AAPL", Money(100));
+    assert(veExec.valuationOf("buyer").unrealizedPnl == Money(buyerHeld * 20 + 4 * 10));
+    assert(veExec.valuationOf("buyer").grossExposure == Money((buyerHeld + 4) * 100));
+    assert(veExec.valuationOf("seller").grossExposure == Money(0));
+    // 入金存入的持仓经 TradeExecutor 导入；非空引擎不能再挂接
+    amAuc.createAccount("vdep", Money(0));
+    execAuc.depositPosition("vdep", "AAPL", 3);
+    assert(amAuc.getAccount("vdep").positionOf("AAPL") == 3);
+    assert(veExec.valuationOf("vdep").marketValue == Money(300) && veExec.valuationOf("vdep").unrealizedPnl == Money(0));
+    assert(veExec.holderCount("AAPL") == 2);
+    thrown = false;
+    try {
+        execAuc.attachValuation(&veExec);
+    } catch (const TradeSimException& e) {
+        thrown = e.code() == ErrorCode::InvalidState;
+    }
+    assert(thrown);
+    execAuc.attachValuation(nullptr);
+
+    // 17) Account 小缓冲持仓：内联 -> 平铺数组，qty 归零即删除，拷贝为深拷贝
+    Account compact("c1", Money(0));
+    compact.addPosition("S1", 5);
+    compact.addPosition("S2", 6);
+    assert(compact.positionCount() == 2);
+    compact.addPosition("S3", 7);
+    compact.addPosition("S4", 8);
+    assert(compact.positionCount() == 4);
+    assert(compact.positionOf("S1") == 5 && compact.positionOf("S4") == 8);
+    assert(compact.positionOf("NEVER_SEEN") == 0);
+    Account copied = compact;
+    compact.addPosition("S3", -7);
+    assert(compact.positionCount() == 3 && compact.positionOf("S3") == 0);
+    assert(copied.positionOf("S3") == 7);
+    std::int64_t sum = 0;
+    copied.forEachPosition([&sum](const Symbol&, std::int64_t q) { sum += q; });
+    assert(sum == 26);
+
+    // 18) AccountManager 稠密表：扩容后引用不失效，查找/重复检测正常
+    AccountManager dense;
+    dense.createAccount("d0", Money(1));
+    Account& first = dense.getAccount("d0");
+    for (int i = 1; i < 1000; ++i) dense.createAccount("d" + std::to_string(i), Money(i));
+    assert(dense.size() == 1000);
+    assert(&first == &dense.getAccount("d0"));
+    assert(dense.getAccount("d999").balance() == Money(999));
+    assert(!dense.exists("d1000"));
+    thrown = false;
+    try {
+        dense.createAccount("d5", Money(0));
+    } catch (const TradeSimException& e) {
+        thrown = e.code() == ErrorCode::Duplicate;
+    }
+    assert(thrown);
+
+    // 19) amend: 同价减量保持时间优先；加量/改价重新排队；低于已成交量拒绝
+    AccountManager amAmend;
+    OrderManager omAmend;
+    MatchingEngine meAmend(MatchingMode::Auction);
+    HistoryManager hmAmend;
+    TradeExecutor execAmend(amAmend, omAmend, meAmend, hmAmend);
+    amAmend.createAccount("b1", Money(100000));
+    amAmend.createAccount("b2", Money(100000));
+    amAmend.createAccount("s1", Money(0));
+    amAmend.getAccount("s1").addPosition("AMD", 10);
+
+    const auto amendA = omAmend.nextId();
+    execAmend.submitAndProcess(OrderFactory::createLimitOrder(amendA, "b1", "AMD", Side::Buy, 5, Money(100)));
+    const auto amendB = omAmend.nextId();
+    execAmend.submitAndProcess(OrderFactory::createLimitOrder(amendB, "b2", "AMD", Side::Buy, 5, Money(100)));
+    const auto amendC = omAmend.nextId();
+    execAmend.submitAndProcess(OrderFactory::createLimitOrder(amendC, "b1", "AMD", Side::Buy, 5, Money(100)));
+    const Order* amendObj = &omAmend.get(amendA);
+
+    const bool keptA = execAmend.amend(amendA, 3, Money(100));  // 就地减量
+    const bool keptC = execAmend.amend(amendC, 5, Money(101));  // 改价：移到新价位
+    const bool keptB = execAmend.amend(amendB, 6, Money(100));  // 加量：排到同价位队尾
+    assert(keptA && !keptC && !keptB);
+    assert(&omAmend.get(amendA) == amendObj && omAmend.get(amendA).qty() == 3);
+    assert(omAmend.get(amendC).limitPrice() == Money(101));
+    assert(meAmend.pendingCount("AMD") == 3);
+
+    execAmend.submitAndProcess(OrderFactory::createLimitOrder(omAmend.nextId(), "s1", "AMD", Side::Sell, 8, Money(100)));
+    auto amendTrades = execAmend.uncrossAndProcess("AMD");
+    assert(amendTrades.size() == 2 && amendTrades[0].price == Money(100));
+    assert(amendTrades[0].buyOrderId == amendC && amendTrades[0].qty == 5); // 价格优先
+    assert(amendTrades[1].buyOrderId == amendA && amendTrades[1].qty == 3); // 减量后仍排在 B 之前
+    assert(meAmend.pendingCount("AMD") == 1);
+    assert(omAmend.status(amendC) == OrderStatus::Filled && omAmend.status(amendA) == OrderStatus::Filled);
+    assert(omAmend.status(amendB) == OrderStatus::Pending);
+
+    thrown = false;
+    try {
+        execAmend.amend(amendC, 5, Money(100)); // 已全部成交，不在簿内
+    } catch (const TradeSimException& e) {
+        thrown = e.code() == ErrorCode::InvalidState;
+    }
+    assert(thrown);
+    thrown = false;
+    try {
+        execAmend.cancel(amendC); // 已全部成交不可撤
+    } catch (const TradeSimException& e) {
+        thrown = e.code() == ErrorCode::InvalidState;
+    }
+    assert(thrown && omAmend.status(amendC) == OrderStatus::Filled);
+
+    // 部分成交后：改到已成交量及以下拒绝，改到以上就地保持优先
+    execAmend.submitAndProcess(OrderFactory::createLimitOrder(omAmend.nextId(), "s1", "AMD", Side::Sell, 2, Money(100)));
+    const auto partialFill = execAmend.uncrossAndProcess("AMD");
+    assert(partialFill.size() == 1);
+    assert(omAmend.status(amendB) == OrderStatus::PartiallyFilled);
+    thrown = false;
+    try {
+        execAmend.amend(amendB, 2, Money(100));
+    } catch (const InvalidArgumentException&) {
+        thrown = true;
+    }
+    assert(thrown && omAmend.get(amendB).qty() == 6);
+    const bool keptReduce = execAmend.amend(amendB, 4, Money(100));
+    assert(keptReduce);
+    assert(omAmend.get(amendB).qty() == 4 && meAmend.pendingCount("AMD") == 1);
+    assert(omAmend.status(amendB) == OrderStatus::PartiallyFilled);
+
+    execAmend.cancel(amendB);
+    thrown = false;
+    try {
+        execAmend.cancel(amendB); // 已撤不可再撤
+    } catch (const TradeSimException& e) {
+        thrown = e.code() == ErrorCode::InvalidState;
+    }
+    assert(thrown);
+    thrown = false;
+    try {
+        execAmend.amend(amendB, 4, Money(100));
+    } catch (const TradeSimException& e) {
+        thrown = e.code() == ErrorCode::InvalidState;
+    }
+    assert(thrown && meAmend.pendingCount("AMD") == 0);
+
+    thrown = false;
+    try {
+        OrderManager omMarket;
+        omMarket.submit(OrderFactory::createMarketOrder(1, "b1", "AMD", Side::Buy, 1));
+        omMarket.amend(1, 2, Money(100));
+    } catch (const InvalidArgumentException&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // 19b) 位置索引：一张长期挂单不让稠密窗口随后续编号增长；老订单仍可改单 / 撤单
+    {
+        MatchingEngine meWin(MatchingMode::Auction);
+        LimitOrder oldest(1, "w", "WIN", Side::Buy, 5, Money(100));
+        (void)meWin.match(oldest);
+        const auto cycles = 3 * MatchingEngine::kDenseSlack;
+        std::size_t maxSlots = 0;
+        for (std::size_t i = 0; i < cycles; ++i) {
+            LimitOrder o(static_cast<OrderId>(i + 2), "w", "WIN", Side::Sell, 1, Money(200));
+            (void)meWin.match(o);
+            meWin.cancel(o);
+            maxSlots = std::max(maxSlots, meWin.locationSlots());
+        }
+        assert(maxSlots <= 2 * MatchingEngine::kDenseSlack + 4096);
+        assert(meWin.restingCount() == 1 && meWin.pendingCount("WIN") == 1);
+        const bool kept = meWin.amend(oldest, 3, Money(100));
+        assert(kept);
+        meWin.cancel(oldest);
+        assert(meWin.restingCount() == 0);
+    }
+
+    // 20) FlightRecorder: 入库 -> 撮合 -> 结算 -> 历史 按序记录；拒单 / 结算失败带 ErrorCode；转储可读回；环满覆盖最旧
+    {
+        AccountManager amFlight;
+        OrderManager omFlight;
+        MatchingEngine meFlight(MatchingMode::Auction);
+        HistoryManager hmFlight;
+        TradeExecutor execFlight(amFlight, omFlight, meFlight, hmFlight);
+        amFlight.createAccount("fb", Money(1000));
+        amFlight.createAccount("fs", Money(0));
+        amFlight.createAccount("poor", Money(0));
+        amFlight.getAccount("fs").addPosition("FLT", 10);
+        const auto history = FlightRecorder::snapshot(); // 前面各块已在本线程环里留下记录，订单号会重复
+        const std::uint64_t firstSeq = history.empty() ? 0 : history.back().seq + 1;
+
+        const auto sellId = omFlight.nextId();
+        execFlight.submitAndProcess(OrderFactory::createLimitOrder(sellId, "fs", "FLT", Side::Sell, 5, Money(100)));
+        const auto buyId = omFlight.nextId();
+        execFlight.submitAndProcess(OrderFactory::createLimitOrder(buyId, "fb", "FLT", Side::Buy, 5, Money(100)));
+        const auto flightTrades = execFlight.uncrossAndProcess("FLT");
+        assert(flightTrades.size() == 1);
+
+        bool thrown = false;
+        try {
+            execFlight.submitAndProcess(OrderFactory::createLimitOrder(sellId, "fs", "FLT", Side::Sell, 5, Money(100)));
+        } catch (const TradeSimException& e) {
+            thrown = e.code() == ErrorCode::Duplicate;
+        }
+        assert(thrown);
+
+        execFlight.submitAndProcess(OrderFactory::createLimitOrder(omFlight.nextId(), "fs", "FLT", Side::Sell, 5, Money(100)));
+        const auto poorId = omFlight.nextId();
+        execFlight.submitAndProcess(OrderFactory::createLimitOrder(poorId, "poor", "FLT", Side::Buy, 5, Money(100)));
+        std::vector<SettlementReject> flightRejects;
+        const auto poorTrades = execFlight.uncrossAndProcess("FLT", &flightRejects);
+        assert(poorTrades.empty() && flightRejects.size() == 1 && flightRejects[0].orderId == poorId);
+        assert(omFlight.status(poorId) == OrderStatus::Rejected);
+
+        // 本线程最近的相关事件
+        std::vector<FlightRecord> mine;
+        for (const auto& r : FlightRecorder::snapshot()) {
+            const bool rejectedSell = r.type == static_cast<std::uint8_t>(FlightEvent::Rejected) && r.orderId == sellId;
+            if (r.seq < firstSeq) continue;
+            if (r.orderId == buyId || r.orderId == poorId || rejectedSell) mine.push_back(r);
+        }
+        const std::vector<FlightEvent> expected{FlightEvent::Accepted, FlightEvent::Matched, FlightEvent::Settled,
+                                                FlightEvent::HistoryRecorded, FlightEvent::Rejected,
+                                                FlightEvent::Accepted, FlightEvent::Matched, FlightEvent::Rejected};
+        assert(mine.size() == expected.size());
+        for (std::size_t i = 0; i < mine.size(); ++i) {
+            assert(mine[i].type == static_cast<std::uint8_t>(expected[i]));
+            if (i > 0) assert(mine[i].seq > mine[i - 1].seq && mine[i].thread == mine[0].thread);
+        }
+        assert(mine[0].qty == 5 && mine[0].price == 100 && mine[0].side == 0);
+        assert(mine[1].tradeId == flightTrades[0].tradeId && mine[1].contraId == sellId && mine[1].qty == 5);
+        assert(mine[4].error == static_cast<std::uint8_t>(ErrorCode::Duplicate));
+        assert(mine[7].error == static_cast<std::uint8_t>(ErrorCode::InsufficientFunds) && mine[7].tradeId != 0);
+
+        const std::string dumpPath = "smoke_test.flight";
+        const auto dumped = FlightRecorder::dump(dumpPath);
+        const auto loaded = FlightRecorder::load(dumpPath);
+        std::remove(dumpPath.c_str());
+        assert(loaded.records.size() == dumped && dumped >= mine.size());
+        bool foundReject = false;
+        for (const auto& r : loaded.records) {
+            if (r.type == static_cast<std::uint8_t>(FlightEvent::Rejected) && r.orderId == poorId) {
+                foundReject = r.error == static_cast<std::uint8_t>(ErrorCode::InsufficientFunds) &&
+                              loaded.nanosBeforeDump(r.ticks) <= 0;
+            }
+        }
+        assert(foundReject);
+
+        // 异常退出路径的转储：路径为空不做事，写失败只报告不抛
+        FlightRecorder::dumpNoThrow("");
+        FlightRecorder::dumpNoThrow("smoke_test.no_such_dir/flight");
+
+        // 写满一圈：只保留最近的记录，seq 连续（槽位最旧的一条可能正被写者覆盖，快照不取）
+        const auto thread = mine[0].thread;
+        for (std::size_t i = 0; i < FlightRecorder::kCapacity + 10; ++i) {
+            FlightRecorder::recordTrade(FlightEvent::Matched, i, 0, 0, 1, Money(1));
+        }
+        std::vector<FlightRecord> ring;
+        for (const auto& r : FlightRecorder::snapshot()) {
+            if (r.thread == thread) ring.push_back(r);
+        }
+        assert(ring.size() == FlightRecorder::kCapacity - 1);
+        assert(ring.front().tradeId == 11 && ring.back().tradeId == FlightRecorder::kCapacity + 9);
+        for (std::size_t i = 1; i < ring.size(); ++i) assert(ring[i].seq == ring[i - 1].seq + 1);
+
+        FlightRecorder::setEnabled(false);
+        const auto frozen = ring.back().seq;
+        FlightRecorder::recordReject(1, ErrorCode::NotFound);
+        assert(FlightRecorder::snapshot().back().seq == frozen);
+        FlightRecorder::setEnabled(true);
+    }
+
+    // 21) Snapshot: 账户/持仓/簿内订单/成交历史/计数器 保存后恢复一致；队列时间优先保持；可叠加再存；损坏文件拒绝
+    {
+        AccountManager amSnap;
+        OrderManager omSnap;
+        MatchingEngine meSnap(MatchingMode::Auction);
+        HistoryManager hmSnap;
+        TradeExecutor execSnap(amSnap, omSnap, meSnap, hmSnap);
+        amSnap.createAccount("sb1", Money(100000));
+        amSnap.createAccount("sb2", Money(100000));
+        amSnap.createAccount("ss", Money(0));
+        amSnap.getAccount("ss").addPosition("SNP", 20);
+        amSnap.getAccount("ss").addPosition("SNQ", 7);
+
+        const auto early = omSnap.nextId();
+        execSnap.submitAndProcess(OrderFactory::createLimitOrder(early, "sb1", "SNP", Side::Buy, 6, Money(100)));
+        const auto late = omSnap.nextId();
+        execSnap.submitAndProcess(OrderFactory::createLimitOrder(late, "sb2", "SNP", Side::Buy, 6, Money(100)));
+        execSnap.submitAndProcess(OrderFactory::createLimitOrder(omSnap.nextId(), "ss", "SNP", Side::Sell, 4, Money(100)));
+        const auto snapTrades = execSnap.uncrossAndProcess("SNP");
+        assert(snapTrades.size() == 1); // early 剩 2
+        const auto mkt = omSnap.nextId();
+        execSnap.submitAndProcess(OrderFactory::createMarketOrder(mkt, "ss", "SNQ", Side::Sell, 3));
+
+        const std::string snapPath = "smoke_test.snapshot";
+        Snapshot::save(snapPath, amSnap, omSnap, meSnap, hmSnap);
+
+        AccountManager amR;
+        OrderManager omR;
+        MatchingEngine meR(MatchingMode::Auction);
+        HistoryManager hmR;
+        auto view = Snapshot::load(snapPath, amR, omR, meR, hmR);
+        assert(amR.size() == 3 && amR.getAccount("sb1").balance() == amSnap.getAccount("sb1").balance());
+        assert(amR.getAccount("ss").positionOf("SNP") == 16 && amR.getAccount("ss").positionOf("SNQ") == 7);
+        assert(amR.getAccount("sb1").positionOf("SNP") == 4 && !amR.exists("nobody"));
+        assert(omR.peekNextId() == omSnap.peekNextId() && meR.nextTradeId() == meSnap.nextTradeId());
+        assert(meR.pendingCount("SNP") == 2 && meR.pendingCount("SNQ") == 1);
+        assert(omR.get(mkt).kind() == OrderKind::Market && omR.get(early).qty() == 6);
+        assert(hmR.tradeCount() == 1 && hmR.historyOf("sb1").size() == 1);
+        assert(hmR.historyOf("ss")[0].symbol == "SNP" && hmR.historyOf("ss")[0].qty == 4);
+
+        // 恢复后继续交易：early 的剩余 2 仍排在 late 之前
+        TradeExecutor execR(amR, omR, meR, hmR);
+        execR.submitAndProcess(OrderFactory::createLimitOrder(omR.nextId(), "ss", "SNP", Side::Sell, 3, Money(100)));
+        const auto after = execR.uncrossAndProcess("SNP");
+        assert(after.size() == 2 && after[0].buyOrderId == early && after[0].qty == 2);
+        assert(after[1].buyOrderId == late && after[1].qty == 1);
+        assert(after[0].tradeId == meSnap.nextTradeId());
+
+        // 快照成交 + 内存成交 合并再存，再恢复
+        const std::string snapPath2 = "smoke_test.snapshot2";
+        Snapshot::save(snapPath2, amR, omR, meR, hmR);
+        AccountManager amR2;
+        OrderManager omR2;
+        MatchingEngine meR2(MatchingMode::Auction);
+        HistoryManager hmR2;
+        Snapshot::load(snapPath2, amR2, omR2, meR2, hmR2);
+        assert(hmR2.tradeCount() == 3);
+        const auto ssHistory = hmR2.historyOf("ss");
+        assert(ssHistory.size() == 3 && ssHistory[0].qty == 4 && ssHistory[1].qty == 2 && ssHistory[2].qty == 1);
+        assert(hmR2.historyOf("sb2").size() == 1 && hmR2.historyOf("sb2")[0].buyOrderId == late);
+        assert(meR2.pendingCount("SNP") == 1 && omR2.peekNextId() == omR.peekNextId());
+
+        // 移动构造 / 移动赋值后，快照索引跟随新对象，源对象析构不影响查询
+        HistoryManager hmMoved;
+        {
+            AccountManager amM;
+            OrderManager omM;
+            MatchingEngine meM(MatchingMode::Auction);
+            HistoryManager hmM;
+            Snapshot::load(snapPath2, amM, omM, meM, hmM);
+            HistoryManager tmp(std::move(hmM));
+            hmMoved = std::move(tmp);
+        }
+        assert(hmMoved.tradeCount() == 3 && hmMoved.historyOf("ss").size() == 3);
+        assert(hmMoved.historyOf("sb2").size() == 1 && hmMoved.historyOf("sb2")[0].buyOrderId == late);
+
+        // 非空管理器拒绝恢复；截断文件拒绝打开
+        bool thrown = false;
+        try {
+            Snapshot::load(snapPath2, amR2, omR2, meR2, hmR2);
+        } catch (const TradeSimException& e) {
+            thrown = e.code() == ErrorCode::InvalidState;
+        }
+        assert(thrown);
+
+        Storage::writeAllLines(snapPath2, {"TSSNAP"});
+        thrown = false;
+        try {
+            SnapshotView::open(snapPath2);
+        } catch (const ParseErrorException&) {
+            thrown = true;
+        }
+        assert(thrown);
+        std::remove(snapPath.c_str());
+        std::remove(snapPath2.c_str());
+
+        // 恢复全有或全无：订单引用不存在的账户 / 订单重号时拒绝，各管理器保持为空
+        AccountManager amBad;
+        OrderManager omBad;
+        MatchingEngine meBad(MatchingMode::Auction);
+        HistoryManager hmBad;
+        TradeExecutor execBad(amBad, omBad, meBad, hmBad);
+        amBad.createAccount("g1", Money(1000));
+        amBad.createAccount("g2", Money(1000));
+        execBad.submitAndProcess(OrderFactory::createLimitOrder(omBad.nextId(), "g1", "SNP", Side::Buy, 1, Money(100)));
+        execBad.submitAndProcess(OrderFactory::createLimitOrder(omBad.nextId(), "g2", "SNP", Side::Buy, 2, Money(100)));
+        const std::string badPath = "smoke_test.snapshot_bad";
+        auto rejectedCleanly = [&badPath] {
+            AccountManager a;
+            OrderManager o;
+            MatchingEngine m(MatchingMode::Auction);
+            HistoryManager h;
+            bool rejected = false;
+            try {
+                Snapshot::load(badPath, a, o, m, h);
+            } catch (const ParseErrorException&) {
+                rejected = true;
+            }
+            return rejected && a.size() == 0 && o.size() == 0 && m.restingCount() == 0 && h.tradeCount() == 0;
+        };
+        // 把第二笔订单记录的 id 改成与第一笔重号（快照无校验和，直接改写文件）
+        Snapshot::save(badPath, amBad, omBad, meBad, hmBad);
+        SnapshotOrder firstRec;
+        SnapshotOrder secondRec;
+        {
+            const auto badView = SnapshotView::open(badPath);
+            const auto recs = badView->section<SnapshotOrder>(SnapshotSection::Orders);
+            assert(recs.size == 2);
+            firstRec = recs[0];
+            secondRec = recs[1];
+        }
+        std::FILE* badFile = std::fopen(badPath.c_str(), "r+b");
+        assert(badFile);
+        std::string badBytes;
+        char chunk[4096];
+        for (std::size_t n; (n = std::fread(chunk, 1, sizeof(chunk), badFile)) > 0;) badBytes.append(chunk, n);
+        const auto recPos = badBytes.find(std::string(reinterpret_cast<const char*>(&secondRec), sizeof(secondRec)));
+        assert(recPos != std::string::npos);
+        SnapshotOrder dupRec = secondRec;
+        dupRec.id = firstRec.id;
+        std::fseek(badFile, static_cast<long>(recPos), SEEK_SET);
+        const auto patched = std::fwrite(&dupRec, sizeof(dupRec), 1, badFile);
+        std::fclose(badFile);
+        assert(patched == 1);
+        const bool dupRejected = rejectedCleanly();
+        assert(dupRejected);
+
+        // 订单所属账户不在快照内（下单不校验账户是否存在）
+        execBad.submitAndProcess(OrderFactory::createLimitOrder(omBad.nextId(), "ghost", "SNP", Side::Sell, 1, Money(100)));
+        Snapshot::save(badPath, amBad, omBad, meBad, hmBad);
+        const bool ghostRejected = rejectedCleanly();
+        assert(ghostRejected);
+        std::remove(badPath.c_str());
+    }
+
+#ifdef TRADE_SIM_HAS_NET
+    // 网关客户端：连接 Unix socket；发一帧请求并读回一帧回报
+    auto connectUnix = [](const std::string& path) {
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        const int connected = ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        assert(connected == 0);
+        return fd;
+    };
+    auto readReport = [](int fd) {
+        char reply[kReportFrameBytes];
+        std::size_t got = 0;
+        while (got < sizeof(reply)) {
+            const auto n = ::recv(fd, reply + got, sizeof(reply) - got, 0);
+            assert(n > 0);
+            got += static_cast<std::size_t>(n);
+        }
+        FrameLength replyLen = 0;
+        std::memcpy(&replyLen, reply, sizeof(replyLen));
+        assert(replyLen == sizeof(WireReport));
+        return decodeReport(reply + sizeof(replyLen));
+    };
+    auto request = [&readReport](int fd, const WireMessage& m) {
+        char frame[kRequestFrameBytes];
+        const FrameLength len = sizeof(WireMessage);
+        std::memcpy(frame, &len, sizeof(len));
+        encodeMessage(m, frame + sizeof(len));
+        const auto sent = ::send(fd, frame, sizeof(frame), 0);
+        assert(sent == static_cast<ssize_t>(sizeof(frame)));
+        return readReport(fd);
+    };
+
+    // 14) OrderGateway: Unix socket 上的长度前缀帧往返
+    {
+        const std::string path = "/tmp/trade_sim_smoke_" + std::to_string(::getpid()) + ".sock";
+        GatewayConfig cfg;
+        cfg.unixPath = path;
+        OrderGateway gateway(handler, cfg);
+        gateway.listen();
+        std::thread loop([&gateway] { gateway.run(); });
+
+        auto connectClient = [&path, &connectUnix] { return connectUnix(path); };
+
+        const int fd = connectClient();
+        WireMessage gdep = dep;
+        gdep.clientSeq = 42;
+        setWireString(gdep.account, "gw1");
+        const WireReport gr = request(fd, gdep);
+        assert(gr.type == static_cast<std::uint8_t>(ReportType::Deposited) && gr.clientSeq == 42);
+
+        // 连接关闭：其未结束订单留在簿内，归属随连接回收
+        WireMessage gbuy = buy;
+        gbuy.clientSeq = 43;
+        gbuy.qty = 1;
+        setWireString(gbuy.account, "gw1");
+        const WireReport ga = request(fd, gbuy);
+        assert(ga.type == static_cast<std::uint8_t>(ReportType::Accepted));
+
+        // 其它连接即使报对账户也不能撤 / 改本连接的订单；本连接改单，Amended 回到本连接
+        const int other = connectClient();
+        WireMessage gcxl;
+        gcxl.type = static_cast<std::uint8_t>(MsgType::Cancel);
+        gcxl.clientSeq = 50;
+        gcxl.orderId = ga.orderId;
+        setWireString(gcxl.account, "gw1");
+        const WireReport stolen = request(other, gcxl);
+        assert(stolen.type == static_cast<std::uint8_t>(ReportType::Rejected) && stolen.clientSeq == 50);
+        assert(stolen.error == static_cast<std::uint8_t>(ErrorCode::NotFound));
+        assert(omWire.status(ga.orderId) == OrderStatus::Pending && gateway.trackedOrders() == 1);
+        ::close(other);
+        WireMessage gamd = gcxl;
+        gamd.type = static_cast<std::uint8_t>(MsgType::Amend);
+        gamd.clientSeq = 51;
+        gamd.qty = 2;
+        gamd.amount = 100;
+        const WireReport amended = request(fd, gamd);
+        assert(amended.type == static_cast<std::uint8_t>(ReportType::Amended) && amended.clientSeq == 51);
+        assert(omWire.get(ga.orderId).qty() == 2);
+        ::close(fd);
+        // 第二个连接的往返完成时，前一连接的 EOF 已在同一轮或更早处理
+        const int fd2 = connectClient();
+        gdep.clientSeq = 44;
+        const WireReport gr2 = request(fd2, gdep);
+        assert(gr2.clientSeq == 44);
+
+        // 半帧跨两次 read 拼接；两帧合在一次 send 里各自处理
+        char frames[2 * kRequestFrameBytes];
+        const FrameLength reqLen = sizeof(WireMessage);
+        for (int k = 0; k < 2; ++k) {
+            gdep.clientSeq = 45 + static_cast<std::uint64_t>(k);
+            std::memcpy(frames + k * kRequestFrameBytes, &reqLen, sizeof(reqLen));
+            encodeMessage(gdep, frames + k * kRequestFrameBytes + sizeof(reqLen));
+        }
+        const std::size_t cut = kRequestFrameBytes / 2;
+        const auto head = ::send(fd2, frames, cut, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const auto tail = ::send(fd2, frames + cut, kRequestFrameBytes - cut, 0);
+        assert(head + tail == static_cast<ssize_t>(kRequestFrameBytes));
+        const WireReport joined = readReport(fd2);
+        assert(joined.clientSeq == 45);
+        gdep.clientSeq = 47;
+        std::memcpy(frames, frames + kRequestFrameBytes, kRequestFrameBytes);
+        encodeMessage(gdep, frames + kRequestFrameBytes + sizeof(reqLen));
+        const auto both = ::send(fd2, frames, sizeof(frames), 0);
+        assert(both == static_cast<ssize_t>(sizeof(frames)));
+        const WireReport first = readReport(fd2);
+        const WireReport second = readReport(fd2);
+        assert(first.clientSeq == 46 && second.clientSeq == 47);
+
+        // fd 用尽：网关腾出预留 fd 接受后立即关闭，客户端读到 EOF；恢复后照常接入
+        {
+            const int pending = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            const int lowestFree = ::dup(0);
+            ::close(lowestFree);
+            rlimit saved{};
+            ::getrlimit(RLIMIT_NOFILE, &saved);
+            rlimit tight = saved;
+            tight.rlim_cur = static_cast<rlim_t>(lowestFree);
+            ::setrlimit(RLIMIT_NOFILE, &tight);
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+            const int connected = ::connect(pending, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+            assert(connected == 0);
+            char eof = 0;
+            const auto n = ::recv(pending, &eof, 1, 0);
+            ::setrlimit(RLIMIT_NOFILE, &saved);
+            assert(n == 0 && gateway.droppedConnections() == 1);
+            ::close(pending);
+            const int fd3 = connectClient();
+            gdep.clientSeq = 48;
+            const WireReport gr3 = request(fd3, gdep);
+            assert(gr3.clientSeq == 48);
+            ::close(fd3);
+        }
+
+        ::close(fd2);
+        gateway.stop();
+        loop.join();
+        assert(amWire.exists("gw1"));
+        assert(omWire.status(ga.orderId) == OrderStatus::Pending && gateway.trackedOrders() == 0);
+    }
+
+    // 22) Replication: 主节点（子进程）边处理边复制，中途被 SIGKILL；备节点与同一输入前缀重放的状态逐字节一致，并可接管
+    {
+        struct ReplNode {
+            AccountManager am;
+            OrderManager om;
+            MatchingEngine me{MatchingMode::Auction};
+            HistoryManager hm;
+            TradeExecutor exec{am, om, me, hm};
+            OrderEntryHandler handler{am, om, exec};
+        };
+        // 主备初始状态相同：16 个账户，各有现金与两只股票的持仓
+        auto seed = [](ReplNode& n) {
+            for (int a = 0; a < 16; ++a) {
+                const auto id = "r" + std::to_string(a);
+                n.am.createAccount(id, Money(1000000));
+                n.am.getAccount(id).addPosition("RPA", 100000);
+                n.am.getAccount(id).addPosition("RPB", 100000);
+            }
+        };
+        // 确定性输入流：入金 / 限价单 / 撤单 / 改单 / 定时出清
+        auto input = [](std::uint64_t i, ReplicationKind& kind) {
+            WireMessage m;
+            kind = ReplicationKind::Message;
+            m.clientSeq = i;
+            setWireString(m.account, "r" + std::to_string(i % 16));
+            setWireString(m.symbol, i % 3 == 0 ? "RPA" : "RPB");
+            if (i % 97 == 0) {
+                kind = ReplicationKind::Uncross;
+            } else if (i % 50 == 1) {
+                m.type = static_cast<std::uint8_t>(MsgType::Deposit);
+                m.amount = 5000;
+            } else if (i % 13 == 0) {
+                m.type = static_cast<std::uint8_t>(MsgType::Cancel);
+                m.orderId = i / 2;
+            } else if (i % 17 == 0) {
+                m.type = static_cast<std::uint8_t>(MsgType::Amend);
+                m.orderId = i - 3;
+                m.qty = 1 + static_cast<std::int64_t>(i % 4);
+                m.amount = 95 + static_cast<std::int64_t>(i % 10);
+            } else {
+                m.type = static_cast<std::uint8_t>(MsgType::NewOrder);
+                m.side = static_cast<std::uint8_t>(i % 2);
+                m.kind = 1;
+                m.qty = 1 + static_cast<std::int64_t>(i % 5);
+                m.amount = 95 + static_cast<std::int64_t>((i * 7) % 11);
+            }
+            return m;
+        };
+        auto apply = [](ReplNode& n, ReplicationKind kind, const WireMessage& m, std::vector<WireReport>& out) {
+            if (kind == ReplicationKind::Uncross) {
+                try {
+                    n.handler.uncrossAll(out);
+                } catch (const TradeSimException&) {
+                }
+            } else {
+                n.handler.handle(m, out);
+            }
+            out.clear();
+        };
+        constexpr std::uint64_t kInputs = 100000;
+
+        const std::string replPath = "/tmp/trade_sim_smoke_repl_" + std::to_string(::getpid()) + ".sock";
+        ReplNode standbyNode;
+        seed(standbyNode);
+        ReplicationConfig rcfg;
+        rcfg.unixPath = replPath;
+        ReplicationStandby standby(standbyNode.handler, rcfg);
+        standby.listen();
+
+        const pid_t primary = ::fork();
+        assert(primary >= 0);
+        if (primary == 0) {
+            // 主节点：每 32 条输入 flush 一批（相当于一轮事件循环），发完后等待被杀
+            ::alarm(30);
+            ReplNode node;
+            seed(node);
+            ReplicationPublisher pub(rcfg);
+            pub.connect();
+            std::vector<WireReport> out;
+            for (std::uint64_t i = 1; i <= kInputs; ++i) {
+                ReplicationKind kind;
+                const auto m = input(i, kind);
+                if (kind == ReplicationKind::Uncross) {
+                    pub.publishUncross();
+                } else {
+                    pub.publish(m);
+                }
+                apply(node, kind, m, out);
+                if (i % 32 == 0) pub.flush();
+            }
+            pub.flush();
+            pub.waitAcked(kInputs, 10000);
+            for (;;) ::pause();
+        }
+
+        bool primaryLost = false;
+        std::thread standbyLoop([&] { primaryLost = standby.run(); });
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+        while (standby.appliedSeq() < kInputs / 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ::kill(primary, SIGKILL);
+        int status = 0;
+        ::waitpid(primary, &status, 0);
+        standbyLoop.join();
+        assert(primaryLost && WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+
+        const auto applied = standby.appliedSeq();
+        assert(applied >= kInputs / 2 && applied <= kInputs);
+
+        // 参照：同一初始状态按序重放前 applied 条输入
+        ReplNode ref;
+        seed(ref);
+        std::vector<WireReport> out;
+        for (std::uint64_t i = 1; i <= applied; ++i) {
+            ReplicationKind kind;
+            const auto m = input(i, kind);
+            apply(ref, kind, m, out);
+        }
+        assert(ref.hm.tradeCount() > 0 && ref.hm.tradeCount() == standbyNode.hm.tradeCount());
+        assert(ref.om.peekNextId() == standbyNode.om.peekNextId());
+        assert(ref.me.nextTradeId() == standbyNode.me.nextTradeId());
+        for (int a = 0; a < 16; ++a) {
+            const auto id = "r" + std::to_string(a);
+            assert(ref.am.getAccount(id).balance() == standbyNode.am.getAccount(id).balance());
+            assert(ref.am.getAccount(id).positionOf("RPA") == standbyNode.am.getAccount(id).positionOf("RPA"));
+            assert(ref.hm.historyOf(id).size() == standbyNode.hm.historyOf(id).size());
+        }
+
+        // 整机状态（账户 / 簿内订单 / 历史 / 计数器）逐字节一致
+        const std::string refSnap = "smoke_test.repl_ref";
+        const std::string standbySnap = "smoke_test.repl_standby";
+        Snapshot::save(refSnap, ref.am, ref.om, ref.me, ref.hm);
+        Snapshot::save(standbySnap, standbyNode.am, standbyNode.om, standbyNode.me, standbyNode.hm);
+        auto readBytes = [](const std::string& path) {
+            std::ifstream in(path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        };
+        const auto refBytes = readBytes(refSnap);
+        assert(!refBytes.empty() && refBytes == readBytes(standbySnap));
+        std::remove(refSnap.c_str());
+        std::remove(standbySnap.c_str());
+
+        // 接管：备节点继续接单，订单号与主节点本应分配的一致
+        WireMessage takeover;
+        takeover.type = static_cast<std::uint8_t>(MsgType::NewOrder);
+        takeover.kind = 1;
+        takeover.qty = 1;
+        takeover.amount = 100;
+        setWireString(takeover.account, "r0");
+        setWireString(takeover.symbol, "RPA");
+        std::vector<WireReport> refOut;
+        standbyNode.handler.handle(takeover, out);
+        ref.handler.handle(takeover, refOut);
+        assert(out.size() == 1 && out[0].type == static_cast<std::uint8_t>(ReportType::Accepted));
+        assert(out[0].orderId == refOut[0].orderId);
+    }
+
+    // 23) SymbolTable: 同进程两个节点各占一个线程，并发驻留 / 查询同一批新 symbol，编号一致且不重复
+    {
+        constexpr int kSyms = 2000;
+        std::vector<SymbolTable::Code> codesA(kSyms);
+        std::vector<SymbolTable::Code> codesB(kSyms);
+        auto worker = [](std::vector<SymbolTable::Code>& codes, bool reverse) {
+            for (int i = 0; i < kSyms; ++i) {
+                const int k = reverse ? kSyms - 1 - i : i;
+                const Symbol sym("ST" + std::to_string(k));
+                codes[k] = SymbolTable::intern(sym);
+                if (SymbolTable::find(sym) != codes[k] || SymbolTable::name(codes[k]) != sym) codes[k] = SymbolTable::npos;
+            }
+        };
+        std::thread a(worker, std::ref(codesA), false);
+        std::thread b(worker, std::ref(codesB), true);
+        a.join();
+        b.join();
+        assert(codesA == codesB);
+        std::vector<SymbolTable::Code> sorted(codesA);
+        std::sort(sorted.begin(), sorted.end());
+        assert(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+        assert(sorted.back() != SymbolTable::npos && sorted.back() < SymbolTable::size());
+    }
+
+    // 24) 同步复制：客户端收到回报时，备节点已应用对应输入（主节点此刻崩溃也不丢已确认的输入）
+    {
+        AccountManager amP;
+        OrderManager omP;
+        MatchingEngine meP(MatchingMode::Auction);
+        HistoryManager hmP;
+        TradeExecutor execP(amP, omP, meP, hmP);
+        OrderEntryHandler handlerP(amP, omP, execP);
+        AccountManager amS;
+        OrderManager omS;
+        MatchingEngine meS(MatchingMode::Auction);
+        HistoryManager hmS;
+        TradeExecutor execS(amS, omS, meS, hmS);
+        OrderEntryHandler handlerS(amS, omS, execS);
+
+        const auto pid = std::to_string(::getpid());
+        ReplicationConfig rcfg;
+        rcfg.unixPath = "/tmp/trade_sim_smoke_sync_repl_" + pid + ".sock";
+        ReplicationStandby standby(handlerS, rcfg);
+        standby.listen();
+        std::thread standbyLoop([&standby] { standby.run(); });
+        ReplicationPublisher pub(rcfg);
+        pub.connect();
+
+        GatewayConfig gcfg;
+        gcfg.unixPath = "/tmp/trade_sim_smoke_sync_gw_" + pid + ".sock";
+        gcfg.replicationSyncMs = 10000;
+        OrderGateway syncGateway(handlerP, gcfg);
+        syncGateway.attachReplication(&pub);
+        syncGateway.listen();
+        std::thread loop([&syncGateway] { syncGateway.run(); });
+
+        const int fd = connectUnix(gcfg.unixPath);
+        WireMessage sdep = dep;
+        for (std::uint64_t i = 1; i <= 50; ++i) {
+            sdep.clientSeq = i;
+            setWireString(sdep.account, "sy" + std::to_string(i));
+            const WireReport r = request(fd, sdep);
+            assert(r.type == static_cast<std::uint8_t>(ReportType::Deposited) && r.clientSeq == i);
+            assert(standby.appliedSeq() >= i);
+        }
+        ::close(fd);
+        syncGateway.stop();
+        loop.join();
+        pub.close();
+        standbyLoop.join();
+        assert(syncGateway.replicationSyncTimeouts() == 0 && amS.exists("sy50"));
+    }
+#endif
+
     return 0;
 }